@@ -0,0 +1,112 @@
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+// counts every allocation of the program, before regex.hpp can make one
+static std::atomic <std::size_t> allocations(0);
+
+void* operator new(const std::size_t size)
+{
+    ++allocations;
+
+    if(void *block = std::malloc(size ? size : 1))
+    {
+        return block;
+    }
+
+    throw std::bad_alloc();
+};
+
+// out of line, or gcc sees the free() of what it takes for a new and warns
+[[gnu::noinline]] static void release(void *block) noexcept
+{
+    std::free(block);
+};
+
+void operator delete(void *block) noexcept
+{
+    release(block);
+};
+
+void operator delete(void *block, const std::size_t) noexcept
+{
+    release(block);
+};
+
+#include "regex.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+
+// checks that matching and searching through a warmed up Context never
+// allocate, for every engine and cache setting; exits with 1 if one does
+//   g++ -std=c++17 -O2 alloc_check.cpp -o alloc_check && ./alloc_check
+
+
+
+int main()
+{
+    // the fixed width engines, the bitset NFA and chains of both
+    std::string large;
+    for(std::size_t itr = 0; itr < 40; ++itr)
+    {
+        large += (itr ? "|(ab*c|ba)x" : "(ab*c|ba)x") + std::string(1, char('a' + itr % 20));
+    }
+
+    const std::vector <std::string> patterns = {
+        "(a|b)*abb(c|a)*", "[a-c]{2,40}x", large, large + "|[abc]{300}"
+    };
+
+    std::string text;
+    for(std::size_t itr = 0; itr < 4000; ++itr)
+    {
+        text += "abbcxaabbxbabacxcabba"[itr % 21];
+    }
+
+    std::vector <rgx::Options> settings(4);
+    settings[1].dfa_cache_limit = 0;
+    settings[2].reverse_search = true;
+    settings[3].dfa_states = 4096;
+
+    bool failed = false;
+
+    for(const std::string &pattern : patterns)
+    {
+        for(std::size_t setting = 0; setting < settings.size(); ++setting)
+        {
+            rgx::Regex<> regex(pattern, settings[setting]);
+            rgx::Regex<>::Context context(regex);
+
+            rgx::Match results[16];
+            std::size_t found = 0;
+
+            const auto run = [&]
+            {
+                found += regex.match(text, context);
+                found += regex.search(text, context);
+                found += regex.search_results(text, results, 16, context);
+                found += regex.search_each(text, [](const std::size_t, const std::size_t) { return true; }, context);
+            };
+
+            // the first round sizes the context and fills the cache
+            run();
+
+            const std::size_t before = allocations;
+            for(std::size_t round = 0; round < 4; ++round)
+            {
+                run();
+            }
+            const std::size_t made = allocations - before;
+
+            std::cout << "pattern of " << pattern.size() << " chars, options " << setting << ": "
+                << made << " allocations (" << found << " found)" << std::endl;
+
+            failed = failed || made != 0;
+        }
+    }
+
+    return failed ? 1 : 0;
+};
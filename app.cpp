@@ -1,4 +1,7 @@
 #include "regex.hpp"
+#include "ostream_trace.hpp"
+
+#include <iostream>
 
 int main()
 {
@@ -6,9 +9,17 @@ int main()
     rgx::Regex<> A("(a\\*b*)*c*\\+\\*");
     // rgx::Regex<> A("(a*b*)*c");
     // rgx::Regex<> A("(ab*)*c*\\*");
-    std::cout << A.match("a*bbbbcccccc+***aa");
+    std::cout << A.match("a*bbbbcccccc+***aa") << std::endl;
+
+    const std::string sample = "a*bbbbcccccc+***aaa*bbbbcccccc+***aa";
+    for(const rgx::Match &match : A.search_results(sample))
+    {
+        std::cout << "Found: \"" << sample.substr(match.begin, match.end - match.begin) << "\" at index " << match.begin << std::endl;
+    }
 
-    std::cout << A.search("a*bbbbcccccc+***aaa*bbbbcccccc+***aa");
+    // same output, through the trace hooks
+    rgx::Regex<std::string, rgx::Ostream_Trace> B("(a\\*b*)*c*\\+\\*");
+    B.search_results(sample);
     // A.search("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
     return 0;
 }
@@ -0,0 +1,133 @@
+#include "dynamic_bitset.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+
+
+
+// ns per operation of the bulk Bitset operations (the SSE2/AVX2 kernels),
+// next to a plain loop over the same words, at 64, 256, 1024 and 16384 bits
+//   g++ -std=c++17 -O2 bench_bitset.cpp -o bench_bitset && ./bench_bitset
+//   g++ -std=c++17 -O2 -mavx2 bench_bitset.cpp -o bench_bitset && ./bench_bitset
+
+
+
+using Bitset_T = bit::Bitset <uint64_t>;
+
+
+// the reference, one word at a time; kept out of line so it is not folded
+// into the timing loop
+template <typename Function_T>
+[[gnu::noinline]] void words(uint64_t *lhs, const uint64_t *rhs, const std::size_t count, const Function_T &function)
+{
+    for(std::size_t itr = 0; itr < count; ++itr)
+    {
+        lhs[itr] = function(lhs[itr], rhs[itr]);
+    }
+};
+
+
+[[gnu::noinline]] bool zero(const uint64_t *data, const std::size_t count)
+{
+    for(std::size_t itr = 0; itr < count; ++itr)
+    {
+        if(data[itr])
+        {
+            return false;
+        }
+    }
+
+    return true;
+};
+
+
+// best of 5 runs of iterations calls, in ns per call
+template <typename Function_T>
+double measure(const std::size_t iterations, const Function_T &function)
+{
+    double best = 0;
+
+    for(std::size_t run = 0; run < 5; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t itr = 0; itr < iterations; ++itr)
+        {
+            function();
+        }
+        const std::chrono::duration <double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double ns = elapsed.count() / iterations;
+        if(run == 0 || ns < best)
+        {
+            best = ns;
+        }
+    }
+
+    return best;
+};
+
+
+
+int main()
+{
+    std::mt19937_64 random(1);
+
+    // keeps the results alive
+    volatile std::size_t sink = 0;
+
+    std::cout << "  bits  op        Bitset   plain loop  (ns)" << std::endl;
+
+    for(const std::size_t bits : {64, 256, 1024, 16384})
+    {
+        Bitset_T lhs(bits);
+        Bitset_T rhs(bits);
+        const Bitset_T empty(bits);
+
+        for(std::size_t pos = 0; pos < bits; ++pos)
+        {
+            lhs.set(pos, random() & 1);
+            rhs.set(pos, random() & 1);
+        }
+
+        const std::size_t count = (bits + 63) / 64;
+        const std::size_t iterations = std::max((std::size_t(1) << 27) / count, std::size_t(1) << 14) / 4;
+
+        const auto report = [&](const char *name, const double bitset, const double plain)
+        {
+            std::cout << std::setw(6) << bits << "  " << std::left << std::setw(6) << name << std::right
+                << std::fixed << std::setprecision(1) << std::setw(10) << bitset << std::setw(13) << plain << std::endl;
+        };
+
+        report("|=",
+            measure(iterations, [&] { lhs |= rhs; sink = sink + lhs.data()[0]; }),
+            measure(iterations, [&] { words(lhs.data(), rhs.data(), count, [](uint64_t a, uint64_t b) { return a | b; }); sink = sink + lhs.data()[0]; })
+        );
+
+        // & alone would empty lhs after a few rounds
+        report("&= ^=",
+            measure(iterations, [&] { lhs &= rhs; lhs ^= rhs; sink = sink + lhs.data()[0]; }),
+            measure(iterations, [&]
+            {
+                words(lhs.data(), rhs.data(), count, [](uint64_t a, uint64_t b) { return a & b; });
+                words(lhs.data(), rhs.data(), count, [](uint64_t a, uint64_t b) { return a ^ b; });
+                sink = sink + lhs.data()[0];
+            })
+        );
+
+        report("flip",
+            measure(iterations, [&] { lhs.flip(); sink = sink + lhs.data()[0]; }),
+            measure(iterations, [&] { words(lhs.data(), lhs.data(), count, [](uint64_t a, uint64_t) { return ~a; }); sink = sink + lhs.data()[0]; })
+        );
+
+        report("none",
+            measure(iterations, [&] { sink = sink + empty.none(); }),
+            measure(iterations, [&] { sink = sink + zero(empty.data(), count); })
+        );
+    }
+
+    return 0;
+};
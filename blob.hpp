@@ -0,0 +1,400 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include "dynamic_bitset.hpp"
+
+
+namespace rgx
+{
+
+
+
+// the binary format Regex::save writes and Regex::load reads: a header, then
+// every table as a 64 bit element count followed by its elements, padded to
+// 8 bytes so each table starts aligned if the blob does (a mapped file does).
+// numbers are stored in the byte order of the saving machine; a machine with
+// another order reads a wrong magic and refuses the blob, as does a reader of
+// another version.
+// a bitset is its size, then either its words or, when that is smaller (most
+// follow sets) and the layout is COMPACT, the 32 bit positions of its set bits.
+// a reader that borrows hands out the words and arrays where they are in the
+// blob instead of copying them, so the blob has to outlive what was read
+struct Blob
+{
+    enum Layout
+    {
+        COMPACT,    // sparse bitsets as their positions, the smallest blob
+        MAPPED      // every bitset as its words, so all of them can be borrowed
+    };
+
+
+    // "rgxblob" and a zero byte, when read back in the same byte order
+    static constexpr const uint64_t MAGIC = 0x00626f6c62786772;
+
+    // bumped with every change of the layout, there is no conversion
+    static constexpr const uint64_t VERSION = 1;
+};
+
+
+
+class Blob_Writer
+{
+    static constexpr const uint64_t DENSE  = 0;
+    static constexpr const uint64_t SPARSE = 1;
+
+
+    const Blob::Layout m_layout;
+
+    std::string m_data;
+
+    // write() scratch
+    std::vector <uint32_t> m_positions;
+
+
+    void pad();
+
+
+public:
+
+    explicit Blob_Writer(const Blob::Layout = Blob::COMPACT) noexcept;
+
+
+    void write(const uint64_t);
+
+    // the count, then the elements (trivially copyable) as they are in memory
+    template <typename Value_T>
+    void write_array(const Value_T*, const std::size_t);
+
+    template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+    void write(const bit::Bitset <Chunk_T, Allocator_T, Inline_N>&);
+
+    // the blob so far, the writer is empty afterwards
+    std::string release() noexcept;
+};
+
+
+
+// reads straight out of the given memory, nothing is buffered; every read is
+// bounds checked and a blob that ends too early throws std::invalid_argument
+class Blob_Reader
+{
+    static constexpr const uint64_t DENSE  = 0;
+    static constexpr const uint64_t SPARSE = 1;
+
+
+    const unsigned char *m_data;
+    std::size_t m_size;
+
+    const bool m_borrow;
+
+    std::size_t m_offset = 0;
+
+    // read() scratch
+    std::vector <uint32_t> m_positions;
+
+
+    // bytes, skipping the padding that follows them
+    const unsigned char* take(const std::size_t);
+
+
+public:
+
+    Blob_Reader(const void *data, const std::size_t size, const bool borrow = false) noexcept;
+
+
+    uint64_t read();
+
+    // like read(), for a size or count that has to fit in std::size_t
+    std::size_t read_size();
+
+    template <typename Value_T, typename Allocator_T>
+    void read_array(std::vector <Value_T, Allocator_T>&);
+
+    template <typename Char_T, typename Traits_T, typename Allocator_T>
+    void read_array(std::basic_string <Char_T, Traits_T, Allocator_T>&);
+
+    // where the count elements are: in the blob if the reader borrows and
+    // they are aligned there, else read into values
+    template <typename Value_T, typename Allocator_T>
+    const Value_T* read_array(std::vector <Value_T, Allocator_T>&, std::size_t &count);
+
+    // of at most max_size bits, a sparse one could claim any size otherwise;
+    // the words of a dense one are borrowed like read_array() does
+    template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+    void read(bit::Bitset <Chunk_T, Allocator_T, Inline_N>&, const std::size_t max_size);
+
+    // bytes not read yet
+    std::size_t remaining() const noexcept;
+
+    // every byte was read
+    bool done() const noexcept;
+
+    [[noreturn]] static void malformed();
+};
+
+
+
+inline Blob_Writer::Blob_Writer(const Blob::Layout layout) noexcept
+    :
+    m_layout(layout)
+{};
+
+
+inline void Blob_Writer::pad()
+{
+    m_data.resize((m_data.size() + 7) / 8 * 8, '\0');
+};
+
+
+inline void Blob_Writer::write(const uint64_t value)
+{
+    m_data.append(reinterpret_cast <const char*>(&value), sizeof(value));
+};
+
+
+template <typename Value_T>
+void Blob_Writer::write_array(const Value_T *values, const std::size_t count)
+{
+    static_assert(std::is_trivially_copyable <Value_T>::value, "only plain values are written as they are");
+
+    write(count);
+    m_data.append(reinterpret_cast <const char*>(values), count * sizeof(Value_T));
+
+    pad();
+};
+
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Blob_Writer::write(const bit::Bitset <Chunk_T, Allocator_T, Inline_N> &bitset)
+{
+    using Bitset_T = bit::Bitset <Chunk_T, Allocator_T, Inline_N>;
+
+    constexpr std::size_t chunk_bits = sizeof(Chunk_T) * CHAR_BIT;
+
+    const std::size_t chunks = (bitset.size() + chunk_bits - 1) / chunk_bits;
+    const std::size_t most = chunks * sizeof(Chunk_T) / sizeof(uint32_t);
+
+    // gathered until they would take more room than the words
+    m_positions.clear();
+
+    std::size_t pos = Bitset_T::npos;
+    if(m_layout == Blob::COMPACT && bitset.size() <= std::numeric_limits <uint32_t>::max())
+    {
+        for(pos = bitset.find_first(); pos != Bitset_T::npos && m_positions.size() < most; pos = bitset.find_next(pos))
+        {
+            m_positions.push_back(static_cast <uint32_t>(pos));
+        }
+    }
+
+    write(bitset.size());
+
+    if(m_layout == Blob::COMPACT && pos == Bitset_T::npos && m_positions.size() < most)
+    {
+        write(SPARSE);
+        write_array(m_positions.data(), m_positions.size());
+    }
+    else
+    {
+        write(DENSE);
+        write_array(bitset.data(), chunks);
+    }
+};
+
+
+inline std::string Blob_Writer::release() noexcept
+{
+    return std::move(m_data);
+};
+
+
+
+inline Blob_Reader::Blob_Reader(const void *data, const std::size_t size, const bool borrow) noexcept
+    :
+    m_data(static_cast <const unsigned char*>(data)),
+    m_size(size),
+    m_borrow(borrow)
+{};
+
+
+inline const unsigned char* Blob_Reader::take(const std::size_t bytes)
+{
+    const std::size_t padded = (bytes + 7) / 8 * 8;
+    if(padded < bytes || padded > m_size - m_offset)
+    {
+        malformed();
+    }
+
+    const unsigned char *taken = m_data + m_offset;
+    m_offset += padded;
+
+    return taken;
+};
+
+
+inline uint64_t Blob_Reader::read()
+{
+    uint64_t value;
+    std::memcpy(&value, take(sizeof(value)), sizeof(value));
+
+    return value;
+};
+
+
+inline std::size_t Blob_Reader::read_size()
+{
+    const uint64_t value = read();
+    if(value > std::numeric_limits <std::size_t>::max())
+    {
+        malformed();
+    }
+
+    return static_cast <std::size_t>(value);
+};
+
+
+template <typename Value_T, typename Allocator_T>
+void Blob_Reader::read_array(std::vector <Value_T, Allocator_T> &values)
+{
+    static_assert(std::is_trivially_copyable <Value_T>::value, "only plain values are read as they are");
+
+    const std::size_t count = read_size();
+    if(count > (m_size - m_offset) / sizeof(Value_T))
+    {
+        malformed();
+    }
+
+    values.resize(count);
+    if(count)
+    {
+        std::memcpy(values.data(), take(count * sizeof(Value_T)), count * sizeof(Value_T));
+    }
+};
+
+
+template <typename Value_T, typename Allocator_T>
+const Value_T* Blob_Reader::read_array(std::vector <Value_T, Allocator_T> &values, std::size_t &count)
+{
+    static_assert(std::is_trivially_copyable <Value_T>::value, "only plain values are read as they are");
+
+    count = read_size();
+    if(count > (m_size - m_offset) / sizeof(Value_T))
+    {
+        malformed();
+    }
+
+    const unsigned char *elements = take(count * sizeof(Value_T));
+    if(m_borrow && reinterpret_cast <std::uintptr_t>(elements) % alignof(Value_T) == 0)
+    {
+        values.clear();
+
+        return reinterpret_cast <const Value_T*>(elements);
+    }
+
+    values.resize(count);
+    if(count)
+    {
+        std::memcpy(values.data(), elements, count * sizeof(Value_T));
+    }
+
+    return values.data();
+};
+
+
+template <typename Char_T, typename Traits_T, typename Allocator_T>
+void Blob_Reader::read_array(std::basic_string <Char_T, Traits_T, Allocator_T> &values)
+{
+    const std::size_t count = read_size();
+    if(count > (m_size - m_offset) / sizeof(Char_T))
+    {
+        malformed();
+    }
+
+    values.resize(count);
+    if(count)
+    {
+        std::memcpy(&values[0], take(count * sizeof(Char_T)), count * sizeof(Char_T));
+    }
+};
+
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Blob_Reader::read(bit::Bitset <Chunk_T, Allocator_T, Inline_N> &bitset, const std::size_t max_size)
+{
+    constexpr std::size_t chunk_bits = sizeof(Chunk_T) * CHAR_BIT;
+
+    const std::size_t size = read_size();
+    const uint64_t kind = read();
+
+    if(size > max_size)
+    {
+        malformed();
+    }
+
+    if(kind == SPARSE)
+    {
+        read_array(m_positions);
+
+        bitset = bit::Bitset <Chunk_T, Allocator_T, Inline_N>(size);
+        for(const uint32_t pos : m_positions)
+        {
+            if(pos >= size)
+            {
+                malformed();
+            }
+
+            bitset.set(pos);
+        }
+
+        return;
+    }
+
+    const std::size_t chunks = read_size();
+    if(kind != DENSE || chunks != size / chunk_bits + (size % chunk_bits != 0) || chunks > (m_size - m_offset) / sizeof(Chunk_T))
+    {
+        malformed();
+    }
+
+    const unsigned char *words = chunks ? take(chunks * sizeof(Chunk_T)) : nullptr;
+    if(m_borrow && reinterpret_cast <std::uintptr_t>(words) % alignof(Chunk_T) == 0)
+    {
+        bitset = bit::Bitset <Chunk_T, Allocator_T, Inline_N>::borrow(reinterpret_cast <const Chunk_T*>(words), size);
+        return;
+    }
+
+    bitset = bit::Bitset <Chunk_T, Allocator_T, Inline_N>(size);
+    if(chunks)
+    {
+        std::memcpy(bitset.data(), words, chunks * sizeof(Chunk_T));
+    }
+};
+
+
+inline std::size_t Blob_Reader::remaining() const noexcept
+{
+    return m_size - m_offset;
+};
+
+
+inline bool Blob_Reader::done() const noexcept
+{
+    return m_offset == m_size;
+};
+
+
+inline void Blob_Reader::malformed()
+{
+    throw std::invalid_argument("malformed regex blob");
+};
+
+
+
+}
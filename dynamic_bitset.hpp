@@ -1,24 +1,96 @@
 #pragma once
 
 #include <vector>
-#include <iostream>
+#include <memory>
+#include <ostream>
 #include <climits>
 #include <algorithm>
 #include <cctype>
+#include <functional>
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 
 namespace bit
 {
 
 
-template <typename Chunk_T = unsigned long long, typename Allocator_T = std::allocator <Chunk_T>>
+template <typename Chunk_T = unsigned long long, typename Allocator_T = std::allocator <Chunk_T>, std::size_t Inline_N = 4>
 class Bitset
 {
 private:
 
+	using Chunk_Alloc_T_ = typename std::allocator_traits <Allocator_T>::template rebind_alloc <Chunk_T>;
+
+	//the chunks, in place while there are at most Inline_N of them and on the heap of Allocator_T past that,
+	//so copying a small bitset never allocates; or borrowed, read where they are and copied out before the
+	//first write, so they may sit in read only memory; only the part of std::vector the bitset needs
+	class Storage_ : private Chunk_Alloc_T_
+	{
+		using Traits_T_ = std::allocator_traits <Chunk_Alloc_T_>;
+
+		static_assert(std::is_trivially_copyable <Chunk_T>::value, "chunks are copied as plain words");
+
+		Chunk_T *data_;																			//inline_, the heap or borrowed (capacity_ 0)
+		std::size_t count_ = 0;
+		std::size_t capacity_ = Inline_N;
+		Chunk_T inline_[Inline_N ? Inline_N : 1];
+
+		Chunk_Alloc_T_& allocator_() noexcept;
+		const Chunk_Alloc_T_& allocator_() const noexcept;
+
+		void own_();																			//copies the borrowed chunks out, if any
+		void grow_(const std::size_t);															//room for at least count chunks, keeps them
+		void release_() noexcept;																//back in place, the chunks are lost
+
+	public:
+
+		constexpr static bool nothrow_move_ = Traits_T_::propagate_on_container_move_assignment::value || Traits_T_::is_always_equal::value;
+
+		explicit Storage_(const Allocator_T&) noexcept;
+		Storage_(const std::size_t, const Chunk_T, const Allocator_T&);
+		Storage_(const Storage_&);
+		Storage_(Storage_&&) noexcept;
+		~Storage_() noexcept;
+
+		Storage_& operator = (const Storage_&);													//reuses the room if the chunks fit
+		Storage_& operator = (Storage_&&) noexcept(nothrow_move_);								//copies if the allocators cant trade memory
+
+
+		constexpr std::size_t size() const noexcept { return count_; };
+		constexpr bool empty() const noexcept { return !count_; };
+
+		Chunk_T* data() { own_(); return data_; };
+		constexpr const Chunk_T* data() const noexcept { return data_; };
+
+		Chunk_T& operator [] (const std::size_t pos) { return data()[pos]; };
+		constexpr const Chunk_T& operator [] (const std::size_t pos) const noexcept { return data_[pos]; };
+
+		Chunk_T* begin() { return data(); };
+		constexpr const Chunk_T* begin() const noexcept { return data_; };
+		Chunk_T* end() { return data() + count_; };
+		constexpr const Chunk_T* end() const noexcept { return data_ + count_; };
+
+		Chunk_T& back() { return data()[count_ - 1]; };
+		constexpr const Chunk_T& back() const noexcept { return data_[count_ - 1]; };
+
+
+		void reserve(const std::size_t);
+		void resize(const std::size_t, const Chunk_T = Chunk_T(0));
+		void push_back(const Chunk_T);
+		void clear() noexcept;																	//keeps the room, same as std::vector
+
+		void borrow(const Chunk_T*, const std::size_t) noexcept;								//count chunks read where they are, never written or freed
+	};
+
 	std::size_t size_;																			//size of the bitset 
-	std::vector <Chunk_T> chunks_;																//array containing the bitset
-	constexpr static std::size_t chunk_size_ = Bitset <Chunk_T, Allocator_T>::sizeof_chunk_();	//how many bits can a chunk hold
+	Storage_ chunks_;																			//array containing the bitset
+	constexpr static std::size_t chunk_size_ = Bitset <Chunk_T, Allocator_T, Inline_N>::sizeof_chunk_();	//how many bits can a chunk hold
 
 	//so we dont compute these a billion times, at runtime
 	constexpr static Chunk_T set_chunk_ = ~Chunk_T(0); 											//1111 1111
@@ -35,7 +107,7 @@ private:
 
 	public:
 
-		constexpr explicit Reference(Bitset <Chunk_T, Allocator_T>&, const std::size_t);
+		constexpr explicit Reference(Bitset <Chunk_T, Allocator_T, Inline_N>&, const std::size_t);
 
 		~Reference() noexcept = default;
 
@@ -86,22 +158,99 @@ public:
 
 	};
 
+	//positions of the set bits, lowest first; keeps the rest of the current chunk so each step is a ctz
+	class One_Iterator
+	{
+		const Bitset <Chunk_T, Allocator_T, Inline_N> *bitset_ = nullptr;
+
+		std::size_t chunk_index_ = 0;
+		Chunk_T rest_ = 0;																		//bits of chunk_index_ not visited yet
+		std::size_t pos_ = npos;
+
+		constexpr void advance_() noexcept;
+
+	public:
+
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const std::size_t*;
+		using reference = std::size_t;
+
+		constexpr One_Iterator() noexcept = default;											//past the end
+
+		constexpr One_Iterator(const Bitset <Chunk_T, Allocator_T, Inline_N>&, const std::size_t) noexcept;	//first set bit at or after pos
+
+
+		constexpr std::size_t operator * () const noexcept;
+
+		constexpr One_Iterator& operator ++ () noexcept;
+		constexpr One_Iterator operator ++ (int) noexcept;
+
+		constexpr bool operator == (const One_Iterator&) const noexcept;
+		constexpr bool operator != (const One_Iterator&) const noexcept;
+
+	};
+
+	//what ones() returns, for range for
+	class One_Range
+	{
+		const Bitset <Chunk_T, Allocator_T, Inline_N> &bitset_;
+		const std::size_t from_;
+
+	public:
+
+		constexpr One_Range(const Bitset <Chunk_T, Allocator_T, Inline_N> &bitset, const std::size_t from) noexcept : bitset_(bitset), from_(from) {};
+
+		constexpr One_Iterator begin() const noexcept { return One_Iterator(bitset_, from_); };
+		constexpr One_Iterator end() const noexcept { return One_Iterator(); };
+
+	};
+
 public:
 
-	constexpr explicit Bitset(const std::size_t = 0, const bool value = false); 				//default constructor							std::vector::vector() (3)
+	constexpr static std::size_t npos = static_cast <std::size_t>(-1);						//returned by find_* when there is no set bit left
+
+	constexpr explicit Bitset(const std::size_t = 0, const bool value = false, const Allocator_T & = Allocator_T());	//default constructor			std::vector::vector() (3)
 
 	constexpr explicit Bitset(const std::initializer_list <bool>);								//initializer list constructor					std::vector::vector() (9)
 
+	Bitset(const Bitset <Chunk_T, Allocator_T, Inline_N>&) = default;										//copy constructor								std::vector::vector() (6)
+
+	Bitset(Bitset <Chunk_T, Allocator_T, Inline_N>&&) noexcept;											//move constructor, leaves rhs empty			std::vector::vector() (8)
+
 	~Bitset() noexcept = default;																//default destructor							std::vector::~vector()
 
+	//size bits read in place from chunks, which must outlive the bitset and every move of it; writing to it
+	//or growing it copies the chunks out first, a copy owns its chunks
+	static Bitset <Chunk_T, Allocator_T, Inline_N> borrow(const Chunk_T*, const std::size_t, const Allocator_T & = Allocator_T());
+
+
+	Bitset <Chunk_T, Allocator_T, Inline_N>& operator = (const Bitset <Chunk_T, Allocator_T, Inline_N>&) = default;	//copy assignment (reuses the chunks if they fit)
+
+	Bitset <Chunk_T, Allocator_T, Inline_N>& operator = (Bitset <Chunk_T, Allocator_T, Inline_N>&&) noexcept(Storage_::nothrow_move_);	//move assignment, leaves rhs empty
+
 
 //-------------------------ELEMENT ACCESS-------------------------
 
 	constexpr bool test(const std::size_t) const;
+	constexpr bool test_unchecked(const std::size_t) const noexcept;							//test() without the range check, pos must be < size()
 
 	constexpr Reference at(const std::size_t);
 
 	constexpr bool none() const;//
+	constexpr bool any() const;
+	constexpr std::size_t count() const noexcept;												//number of set bits
+
+	constexpr bool intersects(const Bitset <Chunk_T, Allocator_T, Inline_N>&) const noexcept;			//any bit set in both, (*this & rhs).any() without the copy
+
+	constexpr std::size_t find_first() const noexcept;											//position of the lowest set bit or npos
+	constexpr std::size_t find_next(const std::size_t) const noexcept;							//position of the lowest set bit after pos or npos
+
+	constexpr One_Range ones(const std::size_t = 0) const noexcept;								//the set bits at or after pos: for(std::size_t pos : bitset.ones())
+
+	constexpr Chunk_T* data() noexcept;																//the chunks, lowest bits first, the unused bits of the last one may be dirty
+	constexpr const Chunk_T* data() const noexcept;
 
 
 //-------------------------CAPACITY-------------------------
@@ -111,29 +260,46 @@ public:
 
 //-------------------------MODIFIERS-------------------------
 
-	constexpr Bitset <Chunk_T, Allocator_T>& clear() noexcept;
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& clear() noexcept;
+
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& resize(const std::size_t = 0, const bool = false);
+
+
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& set();
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& set(const std::size_t, const bool = true);
 
-	constexpr Bitset <Chunk_T, Allocator_T>& resize(const std::size_t = 0, const bool = false);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& reset();
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& reset(const std::size_t);
 
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& set_unchecked(const std::size_t, const bool = true);	//set(pos) and reset(pos) without the range check,
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& reset_unchecked(const std::size_t);					//pos must be < size(), only a borrowed bitset throws (copying its chunks out)
 
-	constexpr Bitset <Chunk_T, Allocator_T>& set();
-	constexpr Bitset <Chunk_T, Allocator_T>& set(const std::size_t, const bool = true);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& flip();
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& flip(const std::size_t);
 
-	constexpr Bitset <Chunk_T, Allocator_T>& reset();
-	constexpr Bitset <Chunk_T, Allocator_T>& reset(const std::size_t);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& operator &= (const Bitset <Chunk_T, Allocator_T, Inline_N>&);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& operator |= (const Bitset <Chunk_T, Allocator_T, Inline_N>&);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& operator ^= (const Bitset <Chunk_T, Allocator_T, Inline_N>&);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N> operator ~ () const;
 
-	constexpr Bitset <Chunk_T, Allocator_T>& flip();
-	constexpr Bitset <Chunk_T, Allocator_T>& flip(const std::size_t);
+	//*this = lhs op rhs in one pass, sized like lhs and reusing the chunks if they fit (no allocation then),
+	//same result as a copy of lhs op= rhs; either may be *this
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& assign_and(const Bitset <Chunk_T, Allocator_T, Inline_N>&, const Bitset <Chunk_T, Allocator_T, Inline_N>&);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& assign_or(const Bitset <Chunk_T, Allocator_T, Inline_N>&, const Bitset <Chunk_T, Allocator_T, Inline_N>&);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& assign_xor(const Bitset <Chunk_T, Allocator_T, Inline_N>&, const Bitset <Chunk_T, Allocator_T, Inline_N>&);
 
-	constexpr Bitset <Chunk_T, Allocator_T>& operator &= (Bitset <Chunk_T, Allocator_T>&);
-	constexpr Bitset <Chunk_T, Allocator_T>& operator |= (Bitset <Chunk_T, Allocator_T>&);
-	constexpr Bitset <Chunk_T, Allocator_T>& operator ^= (Bitset <Chunk_T, Allocator_T>&);
-	constexpr Bitset <Chunk_T, Allocator_T> operator ~ () const;
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N> operator << (const std::size_t) const;
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& operator <<= (const std::size_t);
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N> operator >> (const std::size_t);					//cant be const since bit sanitization must be dealt with
+	constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& operator >>= (const std::size_t);
 
-	constexpr Bitset <Chunk_T, Allocator_T> operator << (const std::size_t) const;
-	constexpr Bitset <Chunk_T, Allocator_T>& operator <<= (const std::size_t);
-	constexpr Bitset <Chunk_T, Allocator_T> operator >> (const std::size_t);					//cant be const since bit sanitization must be dealt with
-	constexpr Bitset <Chunk_T, Allocator_T>& operator >>= (const std::size_t);
+
+//-------------------------COMPARISON-------------------------
+
+	constexpr bool operator == (const Bitset <Chunk_T, Allocator_T, Inline_N>&) const noexcept;
+	constexpr bool operator != (const Bitset <Chunk_T, Allocator_T, Inline_N>&) const noexcept;
+
+	std::size_t hash() const noexcept;															//unused bits are ignored, same as operator ==
 
 
 //-------------------------CONVERSIONS-------------------------
@@ -144,8 +310,8 @@ public:
 
 //-------------------------NON MEMBER FUNCTIOS-------------------------
 
-	template <typename Chunk_FT, typename Allocator_FT, typename Char_T, typename Traits_T>
-	friend std::basic_ostream <Char_T, Traits_T>& operator << (std::basic_ostream <Char_T, Traits_T>&, const Bitset <Chunk_FT, Allocator_FT>&);
+	template <typename Chunk_FT, typename Allocator_FT, std::size_t Inline_FN, typename Char_T, typename Traits_T>
+	friend std::basic_ostream <Char_T, Traits_T>& operator << (std::basic_ostream <Char_T, Traits_T>&, const Bitset <Chunk_FT, Allocator_FT, Inline_FN>&);
 
 private:
 
@@ -161,7 +327,32 @@ private:
 
 	constexpr std::size_t bit_pos_(const std::size_t) const noexcept;
 
+	constexpr static std::size_t lowest_bit_(const Chunk_T) noexcept;							//count trailing zeros, chunk must not be 0
+
+	constexpr static std::size_t popcount_(const Chunk_T) noexcept;
+
+	constexpr std::size_t find_from_chunk_(std::size_t, Chunk_T) const noexcept;
+
 	void set_unused_bits_(const bool = false);													//sanitization tool
+
+	constexpr Chunk_T last_chunk_() const noexcept;												//last chunk with the unused bits cleared
+	constexpr Chunk_T unused_chunk_() const noexcept;											//the unused bits of the last chunk set, the rest cleared
+
+	//-------------------------bulk kernels-------------------------
+	//count chunks at a time, 32 (AVX2) or 16 (SSE2) bytes per step when Chunk_T is a plain integer,
+	//the instruction set is picked at compile time (-mavx2, SSE2 is always there on x86-64), the rest is scalar
+
+	enum class Op_ { AND, OR, XOR };
+
+	template <Op_ op>
+	static void bulk_(Chunk_T*, const Chunk_T*, const Chunk_T*, const std::size_t) noexcept;	//to[i] = lhs[i] op rhs[i], to may be lhs or rhs
+
+	template <Op_ op>
+	Bitset <Chunk_T, Allocator_T, Inline_N>& assign_(const Bitset <Chunk_T, Allocator_T, Inline_N>&, const Bitset <Chunk_T, Allocator_T, Inline_N>&);
+
+	static void flip_(Chunk_T*, const Chunk_T*, const std::size_t) noexcept;					//to[i] = ~from[i], to may be from
+
+	static bool zero_(const Chunk_T*, const std::size_t) noexcept;								//every chunk is 0
 	
 };
 
@@ -175,15 +366,15 @@ private:
 
 //-------------------------constructors-------------------------
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>::Bitset(const std::size_t size, const bool value)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>::Bitset(const std::size_t size, const bool value, const Allocator_T &allocator)
 	:
 	size_(size),
-	chunks_(needed_chunks_(size_), value ? set_chunk_ : zero_chunk_, Allocator_T())
+	chunks_(needed_chunks_(size_), value ? set_chunk_ : zero_chunk_, allocator)
 {};
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>::Bitset(const std::initializer_list <bool> init)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>::Bitset(const std::initializer_list <bool> init)
 	:
 	size_(init.size()),
 	chunks_(Allocator_T())
@@ -217,11 +408,44 @@ constexpr Bitset <Chunk_T, Allocator_T>::Bitset(const std::initializer_list <boo
 	chunks_.push_back(temp_chunk);
 };
 
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N>::Bitset(Bitset <Chunk_T, Allocator_T, Inline_N> &&rhs) noexcept
+	:
+	size_(rhs.size_),
+	chunks_(std::move(rhs.chunks_))
+{
+	rhs.size_ = 0;
+	rhs.chunks_.clear();
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N> Bitset <Chunk_T, Allocator_T, Inline_N>::borrow(const Chunk_T *chunks, const std::size_t size, const Allocator_T &allocator)
+{
+	Bitset <Chunk_T, Allocator_T, Inline_N> bitset(0, false, allocator);
+
+	bitset.size_ = size;
+	bitset.chunks_.borrow(chunks, bitset.needed_chunks_(size));
+
+	return bitset;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::operator = (Bitset <Chunk_T, Allocator_T, Inline_N> &&rhs) noexcept(Storage_::nothrow_move_)
+{
+	size_ = rhs.size_;
+	chunks_ = std::move(rhs.chunks_);
+
+	rhs.size_ = 0;
+	rhs.chunks_.clear();
+
+	return *this;
+};
+
 
 //-------------------------ELEMENT ACCESS-------------------------
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr bool Bitset <Chunk_T, Allocator_T>::test(const std::size_t pos) const
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::test(const std::size_t pos) const
 {
 	if(pos >= size_)
 		throw std::out_of_range(oor_msg_builder_("test", pos));
@@ -229,8 +453,14 @@ constexpr bool Bitset <Chunk_T, Allocator_T>::test(const std::size_t pos) const
 	return chunks_[chunk_pos_(pos)] & (one_chunk_ << bit_pos_(pos));
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr typename Bitset <Chunk_T, Allocator_T>::Reference Bitset <Chunk_T, Allocator_T>::at(const std::size_t pos)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::test_unchecked(const std::size_t pos) const noexcept
+{
+	return chunks_[chunk_pos_(pos)] & (one_chunk_ << bit_pos_(pos));
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::Reference Bitset <Chunk_T, Allocator_T, Inline_N>::at(const std::size_t pos)
 {
 	if(pos >= size_)
 		throw std::out_of_range(oor_msg_builder_("at", pos));
@@ -238,46 +468,100 @@ constexpr typename Bitset <Chunk_T, Allocator_T>::Reference Bitset <Chunk_T, All
 	return Reference(*this, pos);
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr bool Bitset <Chunk_T, Allocator_T>::none() const
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::none() const
+{
+	if(chunks_.empty())
+		return true;
+
+	return zero_(chunks_.data(), chunks_.size() - 1) && last_chunk_() == zero_chunk_;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::any() const
 {
+	return !none();
+};
 
-	std::cout << chunks_.size();
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::count() const noexcept
+{
+	if(chunks_.empty())
+		return 0;
+
+	std::size_t count = popcount_(last_chunk_());
 
 	for(std::size_t itr = 0; itr < chunks_.size() - 1; ++itr)
-	{
-		if(chunks_[itr] != zero_chunk_)
-		{
-			return false;
-		}
-	}
+		count += popcount_(chunks_[itr]);
 
-	const std::size_t remaining_bits = size_ % chunk_size_;		//the remaining (less than chunk_size_) bits that will be initialized as a half chunk
+	return count;
+};
 
-	if(remaining_bits)
-	{
-		if(chunks_.back() << (chunk_size_ - remaining_bits) != zero_chunk_)
-		{
-			return false;
-		}
-	}
-	else
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::intersects(const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs) const noexcept
+{
+	const std::size_t min_size = std::min(chunks_.size(), rhs.chunks_.size());
+
+	if(!min_size)
+		return false;
+
+	for(std::size_t itr = 0; itr < min_size - 1; ++itr)
 	{
-		if(chunks_.back() != zero_chunk_)
-		{
-			return false;
-		}
+		if((chunks_[itr] & rhs.chunks_[itr]) != zero_chunk_)
+			return true;
 	}
 
-	return true;
+	//the unused bits of whichever bitset ends there might be dirty
+	const Chunk_T lhs_last = min_size == chunks_.size() ? last_chunk_() : chunks_[min_size - 1];
+	const Chunk_T rhs_last = min_size == rhs.chunks_.size() ? rhs.last_chunk_() : rhs.chunks_[min_size - 1];
+
+	return (lhs_last & rhs_last) != zero_chunk_;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::find_first() const noexcept
+{
+	if(chunks_.empty())
+		return npos;
+
+	return find_from_chunk_(0, chunks_[0]);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::find_next(const std::size_t pos) const noexcept
+{
+	if(pos + 1 >= size_)
+		return npos;
+
+	const std::size_t chunk_pos = chunk_pos_(pos + 1);
+
+	//drop every bit up to (and including) pos from its chunk
+	return find_from_chunk_(chunk_pos, chunks_[chunk_pos] & (set_chunk_ << bit_pos_(pos + 1)));
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::One_Range Bitset <Chunk_T, Allocator_T, Inline_N>::ones(const std::size_t pos) const noexcept
+{
+	return One_Range(*this, pos);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N> //pure
+constexpr Chunk_T* Bitset <Chunk_T, Allocator_T, Inline_N>::data() noexcept
+{
+	return chunks_.data();
+};
 
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N> //pure
+constexpr const Chunk_T* Bitset <Chunk_T, Allocator_T, Inline_N>::data() const noexcept
+{
+	return chunks_.data();
 };
 
 
 //-------------------------CAPACITY-------------------------
 
-template <typename Chunk_T, typename Allocator_T> //pure
-constexpr std::size_t Bitset <Chunk_T, Allocator_T>::size() const noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N> //pure
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::size() const noexcept
 {
 	return size_;
 };
@@ -285,8 +569,8 @@ constexpr std::size_t Bitset <Chunk_T, Allocator_T>::size() const noexcept
 
 //-------------------------MODIFIERS-------------------------
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::clear() noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::clear() noexcept
 {
 	size_ = 0;
 	chunks_.clear(); //memory will still be allocated, but objects will be destroyed
@@ -294,8 +578,8 @@ constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::clear()
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::resize(const std::size_t size, const bool value)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::resize(const std::size_t size, const bool value)
 {
 	set_unused_bits_(value); //set the newly added bits inside the last half chunk before doing any changes
 
@@ -305,16 +589,16 @@ constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::resize(c
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::set()
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::set()
 {
 	std::fill(chunks_.begin(), chunks_.end(), set_chunk_);
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::set(const std::size_t pos, const bool value)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::set(const std::size_t pos, const bool value)
 {
 	if(pos >= size_)
 		throw std::out_of_range(oor_msg_builder_("set", pos));
@@ -327,33 +611,49 @@ constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::set(cons
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::reset()
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::reset()
 {
 	std::fill(chunks_.begin(), chunks_.end(), zero_chunk_);
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::reset(const std::size_t pos)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::reset(const std::size_t pos)
 {
 	set(pos, false);
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::flip()
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::set_unchecked(const std::size_t pos, const bool value)
 {
-	for(auto &itr : chunks_)
-		itr = ~itr;
+	if(value)
+		chunks_[chunk_pos_(pos)] |= (one_chunk_ << bit_pos_(pos));
+	else
+		chunks_[chunk_pos_(pos)] &= ~(one_chunk_ << bit_pos_(pos));
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T> 
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::flip(const std::size_t pos)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::reset_unchecked(const std::size_t pos)
+{
+	return set_unchecked(pos, false);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::flip()
+{
+	flip_(chunks_.data(), chunks_.data(), chunks_.size());
+
+	return *this;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N> 
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::flip(const std::size_t pos)
 {
 	if(pos >= size_)
 		throw std::out_of_range(oor_msg_builder_("flip", pos));
@@ -363,72 +663,99 @@ constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::flip(con
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::operator &= (Bitset <Chunk_T, Allocator_T> &rhs)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::operator &= (const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
 {
-	std::size_t min_size = size_;
+	std::size_t min_size = chunks_.size();
 
-	if(min_size > rhs.size_)
+	if(min_size >= rhs.chunks_.size())
 	{
-		rhs.set_unused_bits_(true); //set the unused bits to 1 so that &op wont mess around with the result (only needed if rhs chunk overlaps with this and its got unused bits)
-		min_size = rhs.size_;
+		min_size = rhs.chunks_.size();
+
+		if(min_size)
+		{
+			chunks_[min_size - 1] &= (rhs.last_chunk_() | rhs.unused_chunk_()); //unused bits of rhs read as 1 so that &op wont mess around with the result
+			--min_size;
+		}
 	}
 
-	for(std::size_t itr = 0; itr < min_size; ++itr)
-		chunks_[itr] &= rhs.chunks_[itr];
+	bulk_ <Op_::AND>(chunks_.data(), chunks_.data(), rhs.chunks_.data(), min_size);
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::operator |= (Bitset <Chunk_T, Allocator_T> &rhs)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::operator |= (const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
 {
 	std::size_t min_size = chunks_.size();
 
-	if(min_size > rhs.chunks_.size())
+	if(min_size >= rhs.chunks_.size())
 	{
-		rhs.set_unused_bits_(false); //set the unused bits to 0 so that &op wont mess around with the result (only needed if rhs chunk overlaps with this and its got unused bits)
 		min_size = rhs.chunks_.size();
+
+		if(min_size)
+		{
+			chunks_[min_size - 1] |= rhs.last_chunk_(); //unused bits of rhs read as 0 so that |op wont mess around with the result
+			--min_size;
+		}
 	}
 
-	for(std::size_t itr = 0; itr < min_size; ++itr)
-		chunks_[itr] |= rhs.chunks_[itr];
+	bulk_ <Op_::OR>(chunks_.data(), chunks_.data(), rhs.chunks_.data(), min_size);
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::operator ^= (Bitset <Chunk_T, Allocator_T> &rhs)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::operator ^= (const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
 {
-	std::size_t min_size = size_;
+	std::size_t min_size = chunks_.size();
 
-	if(min_size > rhs.size_)
+	if(min_size >= rhs.chunks_.size())
 	{
-		rhs.set_unused_bits_(false); //set the unused bits to 0 so that &op wont mess around with the result (only needed if rhs chunk overlaps with this and its got unused bits)
-		min_size = rhs.size_;
+		min_size = rhs.chunks_.size();
+
+		if(min_size)
+		{
+			chunks_[min_size - 1] ^= rhs.last_chunk_(); //unused bits of rhs read as 0 so that ^op wont mess around with the result
+			--min_size;
+		}
 	}
 
-	for(std::size_t itr = 0; itr < min_size; ++itr)
-		chunks_[itr] ^= rhs.chunks_[itr];
+	bulk_ <Op_::XOR>(chunks_.data(), chunks_.data(), rhs.chunks_.data(), min_size);
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T> Bitset <Chunk_T, Allocator_T>::operator ~ () const
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::assign_and(const Bitset <Chunk_T, Allocator_T, Inline_N> &lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
+{
+	return assign_ <Op_::AND>(lhs, rhs);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::assign_or(const Bitset <Chunk_T, Allocator_T, Inline_N> &lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
 {
-	Bitset <Chunk_T, Allocator_T> flipped;
-	flipped.chunks_.reserve(chunks_.size());
-	flipped.size_ = size_;
+	return assign_ <Op_::OR>(lhs, rhs);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::assign_xor(const Bitset <Chunk_T, Allocator_T, Inline_N> &lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
+{
+	return assign_ <Op_::XOR>(lhs, rhs);
+};
 
-	for(auto &chunk : chunks_)
-		flipped.chunks_.push_back(~chunk);
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N> Bitset <Chunk_T, Allocator_T, Inline_N>::operator ~ () const
+{
+	Bitset <Chunk_T, Allocator_T, Inline_N> flipped(size_);
+
+	flip_(flipped.chunks_.data(), chunks_.data(), chunks_.size());
 
 	return flipped;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T> Bitset <Chunk_T, Allocator_T>::operator << (const std::size_t pos) const
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N> Bitset <Chunk_T, Allocator_T, Inline_N>::operator << (const std::size_t pos) const
 {
 	//shift chunks to right (increase value)
 	//unused bits should still be outside reach, therefore no need to mess with them
@@ -436,9 +763,9 @@ constexpr Bitset <Chunk_T, Allocator_T> Bitset <Chunk_T, Allocator_T>::operator
 		return *this;
 
 	if(pos >= size_)
-		return Bitset <Chunk_T, Allocator_T>(size_);
+		return Bitset <Chunk_T, Allocator_T, Inline_N>(size_);
 
-	Bitset <Chunk_T, Allocator_T> shifted(size_); //empty bitset
+	Bitset <Chunk_T, Allocator_T, Inline_N> shifted(size_); //empty bitset
 
 	const std::size_t left_offset = pos % chunk_size_;				//left part (smaller) of the chunk will become the right (larger) part of the new chunk
 	const std::size_t right_offset = chunk_size_ - left_offset; 	//right part (larger) of the chunk will become the left (smallest) part of the new chunk
@@ -462,8 +789,8 @@ constexpr Bitset <Chunk_T, Allocator_T> Bitset <Chunk_T, Allocator_T>::operator
 	return shifted;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::operator <<= (const std::size_t pos)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::operator <<= (const std::size_t pos)
 {
 	if(!pos)
 		return *this;
@@ -498,8 +825,8 @@ constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::operator
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T> Bitset <Chunk_T, Allocator_T>::operator >> (const std::size_t pos) //not const since might need to sanitize some bits...
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N> Bitset <Chunk_T, Allocator_T, Inline_N>::operator >> (const std::size_t pos) //not const since might need to sanitize some bits...
 {
 	//shift chunks to left (decrease value)
 	//unused bits are definetely a problem...
@@ -507,11 +834,11 @@ constexpr Bitset <Chunk_T, Allocator_T> Bitset <Chunk_T, Allocator_T>::operator
 		return *this;
 
 	if(pos >= size_)
-		return Bitset <Chunk_T, Allocator_T>(size_);
+		return Bitset <Chunk_T, Allocator_T, Inline_N>(size_);
 
 	set_unused_bits_(false);
 
-	Bitset <Chunk_T, Allocator_T> shifted(size_); //empty bitset
+	Bitset <Chunk_T, Allocator_T, Inline_N> shifted(size_); //empty bitset
 
 	const std::size_t left_offset = pos % chunk_size_; 				//left part (smaller) of the chunk will become the right (larger) part of the new chunk
 	const std::size_t right_offset = chunk_size_ - left_offset; 	//right part (larger) of the chunk will become the left (smallest) part of the new chunk
@@ -535,8 +862,8 @@ constexpr Bitset <Chunk_T, Allocator_T> Bitset <Chunk_T, Allocator_T>::operator
 	return shifted;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::operator >>= (const std::size_t pos)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::operator >>= (const std::size_t pos)
 {
 	//shift chunks to left (decrease value)
 	if(!pos)
@@ -575,11 +902,55 @@ constexpr Bitset <Chunk_T, Allocator_T>& Bitset <Chunk_T, Allocator_T>::operator
 }
 
 
+//-------------------------COMPARISON-------------------------
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::operator == (const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs) const noexcept
+{
+	if(size_ != rhs.size_)
+		return false;
+
+	if(chunks_.empty())
+		return true;
+
+	for(std::size_t itr = 0; itr < chunks_.size() - 1; ++itr)
+	{
+		if(chunks_[itr] != rhs.chunks_[itr])
+			return false;
+	}
+
+	return last_chunk_() == rhs.last_chunk_();
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::operator != (const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs) const noexcept
+{
+	return !(*this == rhs);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::hash() const noexcept
+{
+	std::size_t seed = size_;
+
+	if(chunks_.empty())
+		return seed;
+
+	//boost::hash_combine
+	for(std::size_t itr = 0; itr < chunks_.size() - 1; ++itr)
+		seed ^= std::hash <Chunk_T>()(chunks_[itr]) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+
+	seed ^= std::hash <Chunk_T>()(last_chunk_()) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+
+	return seed;
+};
+
+
 //-------------------------CONVERSIONS-------------------------
 
-template <typename Chunk_T, typename Allocator_T>
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
 template <typename Char_T, typename Traits_T, typename Str_Allocator_T>
-constexpr std::basic_string <Char_T, Traits_T, Str_Allocator_T> Bitset<Chunk_T, Allocator_T>::to_string(const Char_T zero, const Char_T one) const
+constexpr std::basic_string <Char_T, Traits_T, Str_Allocator_T> Bitset <Chunk_T, Allocator_T, Inline_N>::to_string(const Char_T zero, const Char_T one) const
 {
 	std::basic_string <Char_T, Traits_T, Str_Allocator_T> tmp(size_, zero);
 
@@ -599,8 +970,8 @@ constexpr std::basic_string <Char_T, Traits_T, Str_Allocator_T> Bitset<Chunk_T,
 
 //-------------------------NON MEMBER FUNCTIOS-------------------------
 
-template <typename Chunk_T, typename Allocator_T, typename Char_T, typename Traits_T>
-std::basic_ostream <Char_T, Traits_T>& operator << (std::basic_ostream <Char_T, Traits_T>&out, const Bitset <Chunk_T, Allocator_T> &mask)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N, typename Char_T, typename Traits_T>
+std::basic_ostream <Char_T, Traits_T>& operator << (std::basic_ostream <Char_T, Traits_T>&out, const Bitset <Chunk_T, Allocator_T, Inline_N> &mask)
 {
 	//i sure hope this is enough to make it portable, must investigate further
 	if(!mask.size_)
@@ -612,17 +983,65 @@ std::basic_ostream <Char_T, Traits_T>& operator << (std::basic_ostream <Char_T,
 	return out << mask.template to_string <Char_T, Traits_T, std::allocator <Char_T>> (zero, one);
 };
 
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N> operator & (const Bitset <Chunk_T, Allocator_T, Inline_N> &lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
+{
+	Bitset <Chunk_T, Allocator_T, Inline_N> result;
+
+	result.assign_and(lhs, rhs);
+
+	return result;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N> operator & (Bitset <Chunk_T, Allocator_T, Inline_N> &&lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)	//reuses the chunks of lhs
+{
+	return std::move(lhs &= rhs);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N> operator | (const Bitset <Chunk_T, Allocator_T, Inline_N> &lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
+{
+	Bitset <Chunk_T, Allocator_T, Inline_N> result;
+
+	result.assign_or(lhs, rhs);
+
+	return result;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N> operator | (Bitset <Chunk_T, Allocator_T, Inline_N> &&lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)	//reuses the chunks of lhs
+{
+	return std::move(lhs |= rhs);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N> operator ^ (const Bitset <Chunk_T, Allocator_T, Inline_N> &lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
+{
+	Bitset <Chunk_T, Allocator_T, Inline_N> result;
+
+	result.assign_xor(lhs, rhs);
+
+	return result;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N> operator ^ (Bitset <Chunk_T, Allocator_T, Inline_N> &&lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)	//reuses the chunks of lhs
+{
+	return std::move(lhs ^= rhs);
+};
+
 
 //-------------------------private helpers/getters-------------------------
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr std::size_t Bitset <Chunk_T, Allocator_T>::needed_chunks_(const std::size_t size) const noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::needed_chunks_(const std::size_t size) const noexcept
 {
 	return size / chunk_size_ + (size % chunk_size_ > 0);
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr std::size_t Bitset <Chunk_T, Allocator_T>::sizeof_chunk_() noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::sizeof_chunk_() noexcept
 {
 	if constexpr (std::is_integral<Chunk_T>::value)
 		return sizeof(Chunk_T) * CHAR_BIT;
@@ -630,8 +1049,8 @@ constexpr std::size_t Bitset <Chunk_T, Allocator_T>::sizeof_chunk_() noexcept
 		return Chunk_T::sizeof_ * CHAR_BIT;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr std::string Bitset <Chunk_T, Allocator_T>::oor_msg_builder_(const std::string &which, const std::size_t pos) const
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::string Bitset <Chunk_T, Allocator_T, Inline_N>::oor_msg_builder_(const std::string &which, const std::size_t pos) const
 {
 	return std::string(		
 		"bit::Bitset::"
@@ -644,20 +1063,70 @@ constexpr std::string Bitset <Chunk_T, Allocator_T>::oor_msg_builder_(const std:
 	);
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr std::size_t Bitset <Chunk_T, Allocator_T>::chunk_pos_(const std::size_t pos) const noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::chunk_pos_(const std::size_t pos) const noexcept
 {
 	return pos / chunk_size_;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr std::size_t Bitset <Chunk_T, Allocator_T>::bit_pos_(const std::size_t pos) const noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::bit_pos_(const std::size_t pos) const noexcept
 {
 	return pos % chunk_size_;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-void Bitset <Chunk_T, Allocator_T>::set_unused_bits_(const bool value) //noexcept if chunks isnt empty !!!!MAKE SURE THIS WORKS
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::lowest_bit_(const Chunk_T chunk) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	if constexpr (std::is_integral<Chunk_T>::value && sizeof(Chunk_T) <= sizeof(unsigned long long))
+		return __builtin_ctzll(static_cast <unsigned long long>(chunk));
+#endif
+
+	std::size_t bit_pos = 0;
+	while(!(chunk & (one_chunk_ << bit_pos)))
+		++bit_pos;
+
+	return bit_pos;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::popcount_(Chunk_T chunk) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	if constexpr (std::is_integral<Chunk_T>::value && sizeof(Chunk_T) <= sizeof(unsigned long long))
+		return __builtin_popcountll(static_cast <unsigned long long>(chunk));
+#endif
+
+	std::size_t count = 0;
+	for(std::size_t bit_pos = 0; bit_pos < chunk_size_; ++bit_pos)
+	{
+		if(chunk & (one_chunk_ << bit_pos))
+			++count;
+	}
+
+	return count;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::find_from_chunk_(std::size_t chunk_pos, Chunk_T chunk) const noexcept
+{
+	//chunk is the (already masked) value of chunks_[chunk_pos]
+	while(chunk == zero_chunk_)
+	{
+		if(++chunk_pos >= chunks_.size())
+			return npos;
+
+		chunk = chunks_[chunk_pos];
+	}
+
+	const std::size_t pos = chunk_pos * chunk_size_ + lowest_bit_(chunk);
+
+	return pos < size_ ? pos : npos;	//unused bits might be dirty
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::set_unused_bits_(const bool value) //noexcept if chunks isnt empty !!!!MAKE SURE THIS WORKS
 {
 	std::size_t bit_pos = bit_pos_(size_);
 
@@ -670,6 +1139,503 @@ void Bitset <Chunk_T, Allocator_T>::set_unused_bits_(const bool value) //noexcep
 	}
 };
 
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Chunk_T Bitset <Chunk_T, Allocator_T, Inline_N>::last_chunk_() const noexcept
+{
+	const std::size_t bit_pos = bit_pos_(size_);
+
+	if(bit_pos)
+		return chunks_.back() & ~(set_chunk_ << bit_pos);
+
+	return chunks_.back();
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Chunk_T Bitset <Chunk_T, Allocator_T, Inline_N>::unused_chunk_() const noexcept
+{
+	const std::size_t bit_pos = bit_pos_(size_);
+
+	if(bit_pos)
+		return set_chunk_ << bit_pos;
+
+	return 0;
+};
+
+
+//-------------------------private bulk kernels-------------------------
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+template <typename Bitset <Chunk_T, Allocator_T, Inline_N>::Op_ op>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::bulk_(Chunk_T *to, const Chunk_T *lhs, const Chunk_T *rhs, const std::size_t count) noexcept
+{
+	std::size_t itr = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	if constexpr (std::is_integral <Chunk_T>::value)
+	{
+	#if defined(__AVX2__)
+		constexpr std::size_t wide = 32 / sizeof(Chunk_T);		//chunks per 256 bit vector
+
+		for(; itr + wide <= count; itr += wide)
+		{
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast <const __m256i*>(lhs + itr));
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast <const __m256i*>(rhs + itr));
+
+			if constexpr (op == Op_::AND)
+				_mm256_storeu_si256(reinterpret_cast <__m256i*>(to + itr), _mm256_and_si256(a, b));
+			else if constexpr (op == Op_::OR)
+				_mm256_storeu_si256(reinterpret_cast <__m256i*>(to + itr), _mm256_or_si256(a, b));
+			else
+				_mm256_storeu_si256(reinterpret_cast <__m256i*>(to + itr), _mm256_xor_si256(a, b));
+		}
+	#endif
+
+		constexpr std::size_t narrow = 16 / sizeof(Chunk_T);	//chunks per 128 bit vector
+
+		for(; itr + narrow <= count; itr += narrow)
+		{
+			const __m128i a = _mm_loadu_si128(reinterpret_cast <const __m128i*>(lhs + itr));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast <const __m128i*>(rhs + itr));
+
+			if constexpr (op == Op_::AND)
+				_mm_storeu_si128(reinterpret_cast <__m128i*>(to + itr), _mm_and_si128(a, b));
+			else if constexpr (op == Op_::OR)
+				_mm_storeu_si128(reinterpret_cast <__m128i*>(to + itr), _mm_or_si128(a, b));
+			else
+				_mm_storeu_si128(reinterpret_cast <__m128i*>(to + itr), _mm_xor_si128(a, b));
+		}
+	}
+#endif
+
+	for(; itr < count; ++itr)
+	{
+		if constexpr (op == Op_::AND)
+			to[itr] = lhs[itr] & rhs[itr];
+		else if constexpr (op == Op_::OR)
+			to[itr] = lhs[itr] | rhs[itr];
+		else
+			to[itr] = lhs[itr] ^ rhs[itr];
+	}
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+template <typename Bitset <Chunk_T, Allocator_T, Inline_N>::Op_ op>
+Bitset <Chunk_T, Allocator_T, Inline_N>& Bitset <Chunk_T, Allocator_T, Inline_N>::assign_(const Bitset <Chunk_T, Allocator_T, Inline_N> &lhs, const Bitset <Chunk_T, Allocator_T, Inline_N> &rhs)
+{
+	//resizing *this would resize rhs under our feet
+	if(this == &rhs && this != &lhs)
+	{
+		Bitset <Chunk_T, Allocator_T, Inline_N> result;
+		result.assign_ <op>(lhs, rhs);
+
+		return *this = std::move(result);
+	}
+
+	size_ = lhs.size_;
+	chunks_.resize(lhs.chunks_.size());
+
+	std::size_t min_size = lhs.chunks_.size();
+
+	//same as the compound operators: past rhs lhs is kept as is, the unused bits of rhs read as the identity of op
+	if(min_size >= rhs.chunks_.size())
+	{
+		min_size = rhs.chunks_.size();
+
+		if(this != &lhs)
+			std::copy(lhs.chunks_.begin() + min_size, lhs.chunks_.end(), chunks_.begin() + min_size);
+
+		if(min_size)
+		{
+			--min_size;
+
+			const Chunk_T last = op == Op_::AND ? rhs.last_chunk_() | rhs.unused_chunk_() : rhs.last_chunk_();
+			bulk_ <op>(chunks_.data() + min_size, lhs.chunks_.data() + min_size, &last, 1);
+		}
+	}
+
+	bulk_ <op>(chunks_.data(), lhs.chunks_.data(), rhs.chunks_.data(), min_size);
+
+	return *this;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::flip_(Chunk_T *to, const Chunk_T *from, const std::size_t count) noexcept
+{
+	std::size_t itr = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	if constexpr (std::is_integral <Chunk_T>::value)
+	{
+	#if defined(__AVX2__)
+		constexpr std::size_t wide = 32 / sizeof(Chunk_T);
+
+		for(; itr + wide <= count; itr += wide)
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast <const __m256i*>(from + itr));
+			_mm256_storeu_si256(reinterpret_cast <__m256i*>(to + itr), _mm256_xor_si256(chunk, _mm256_set1_epi8(-1)));
+		}
+	#endif
+
+		constexpr std::size_t narrow = 16 / sizeof(Chunk_T);
+
+		for(; itr + narrow <= count; itr += narrow)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast <const __m128i*>(from + itr));
+			_mm_storeu_si128(reinterpret_cast <__m128i*>(to + itr), _mm_xor_si128(chunk, _mm_set1_epi8(-1)));
+		}
+	}
+#endif
+
+	for(; itr < count; ++itr)
+		to[itr] = ~from[itr];
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+bool Bitset <Chunk_T, Allocator_T, Inline_N>::zero_(const Chunk_T *chunks, const std::size_t count) noexcept
+{
+	std::size_t itr = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	if constexpr (std::is_integral <Chunk_T>::value)
+	{
+		//two vectors are or-ed together before each test, one branch per step
+	#if defined(__AVX2__)
+		constexpr std::size_t wide = 32 / sizeof(Chunk_T);
+
+		for(; itr + 2 * wide <= count; itr += 2 * wide)
+		{
+			const __m256i chunk = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast <const __m256i*>(chunks + itr)),
+												  _mm256_loadu_si256(reinterpret_cast <const __m256i*>(chunks + itr + wide)));
+			if(!_mm256_testz_si256(chunk, chunk))
+				return false;
+		}
+	#endif
+
+		constexpr std::size_t narrow = 16 / sizeof(Chunk_T);
+
+		for(; itr + 2 * narrow <= count; itr += 2 * narrow)
+		{
+			const __m128i chunk = _mm_or_si128(_mm_loadu_si128(reinterpret_cast <const __m128i*>(chunks + itr)),
+											   _mm_loadu_si128(reinterpret_cast <const __m128i*>(chunks + itr + narrow)));
+			if(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_setzero_si128())) != 0xFFFF)
+				return false;
+		}
+	}
+#endif
+
+	for(; itr < count; ++itr)
+	{
+		if(chunks[itr] != zero_chunk_)
+			return false;
+	}
+
+	return true;
+};
+
+
+/*
+============================================================================
+-------------------------class Storage_ methods BEGIN-------------------------
+============================================================================
+*/
+
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::Storage_(const Allocator_T &allocator) noexcept
+	:
+	Chunk_Alloc_T_(allocator),
+	data_(inline_)
+{};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::Storage_(const std::size_t count, const Chunk_T value, const Allocator_T &allocator)
+	:
+	Storage_(allocator)
+{
+	resize(count, value);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::Storage_(const Storage_ &rhs)
+	:
+	Chunk_Alloc_T_(Traits_T_::select_on_container_copy_construction(rhs.allocator_())),
+	data_(inline_)
+{
+	grow_(rhs.count_);
+
+	std::copy(rhs.begin(), rhs.end(), data_);
+	count_ = rhs.count_;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::Storage_(Storage_ &&rhs) noexcept
+	:
+	Chunk_Alloc_T_(std::move(rhs.allocator_())),
+	data_(inline_),
+	count_(rhs.count_)
+{
+	if(rhs.data_ != rhs.inline_)
+	{
+		data_ = rhs.data_;
+		capacity_ = rhs.capacity_;
+
+		rhs.data_ = rhs.inline_;
+		rhs.capacity_ = Inline_N;
+	}
+	else
+		std::copy(rhs.inline_, rhs.inline_ + count_, inline_);
+
+	rhs.count_ = 0;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::~Storage_() noexcept
+{
+	release_();
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+typename Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_& Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::operator = (const Storage_ &rhs)
+{
+	if(this == &rhs)
+		return *this;
+
+	if constexpr (Traits_T_::propagate_on_container_copy_assignment::value)
+	{
+		if(allocator_() != rhs.allocator_())
+		{
+			release_();
+			count_ = 0;
+		}
+
+		allocator_() = rhs.allocator_();
+	}
+
+	count_ = 0;
+	own_();
+	grow_(rhs.count_);
+
+	std::copy(rhs.begin(), rhs.end(), data_);
+	count_ = rhs.count_;
+
+	return *this;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+typename Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_& Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::operator = (Storage_ &&rhs) noexcept(nothrow_move_)
+{
+	if(this == &rhs)
+		return *this;
+
+	//the heap of rhs can only be taken over if this allocator is able to free it later
+	if(rhs.data_ == rhs.inline_ || (!Traits_T_::propagate_on_container_move_assignment::value && allocator_() != rhs.allocator_()))
+	{
+		*this = static_cast <const Storage_&>(rhs);
+		rhs.count_ = 0;
+
+		return *this;
+	}
+
+	release_();
+
+	if constexpr (Traits_T_::propagate_on_container_move_assignment::value)
+		allocator_() = std::move(rhs.allocator_());
+
+	data_ = rhs.data_;
+	count_ = rhs.count_;
+	capacity_ = rhs.capacity_;
+
+	rhs.data_ = rhs.inline_;
+	rhs.count_ = 0;
+	rhs.capacity_ = Inline_N;
+
+	return *this;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::reserve(const std::size_t count)
+{
+	own_();
+	grow_(count);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::resize(const std::size_t count, const Chunk_T value)
+{
+	own_();
+	grow_(count);
+
+	if(count > count_)
+		std::fill(data_ + count_, data_ + count, value);
+
+	count_ = count;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::push_back(const Chunk_T value)
+{
+	own_();
+	grow_(count_ + 1);
+
+	data_[count_++] = value;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::clear() noexcept
+{
+	count_ = 0;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::borrow(const Chunk_T *data, const std::size_t count) noexcept
+{
+	release_();
+
+	if(!count)
+	{
+		count_ = 0;
+		return;
+	}
+
+	//only ever read through data_, everything that writes calls own_() first
+	data_ = const_cast <Chunk_T*>(data);
+	count_ = count;
+	capacity_ = 0;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+typename Bitset <Chunk_T, Allocator_T, Inline_N>::Chunk_Alloc_T_& Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::allocator_() noexcept
+{
+	return *this;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+const typename Bitset <Chunk_T, Allocator_T, Inline_N>::Chunk_Alloc_T_& Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::allocator_() const noexcept
+{
+	return *this;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::own_()
+{
+	if(capacity_)
+		return;
+
+	//borrowed, nothing changes if the allocation throws
+	Chunk_T *data = count_ <= Inline_N ? inline_ : Traits_T_::allocate(allocator_(), count_);
+	std::copy(data_, data_ + count_, data);
+
+	data_ = data;
+	capacity_ = std::max(count_, Inline_N);
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::grow_(const std::size_t count)
+{
+	if(count <= capacity_)
+		return;
+
+	const std::size_t capacity = std::max(count, 2 * capacity_);	//amortized push_back
+
+	Chunk_T *data = Traits_T_::allocate(allocator_(), capacity);
+	std::copy(data_, data_ + count_, data);
+
+	release_();
+
+	data_ = data;
+	capacity_ = capacity;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+void Bitset <Chunk_T, Allocator_T, Inline_N>::Storage_::release_() noexcept
+{
+	if(data_ != inline_ && capacity_)
+		Traits_T_::deallocate(allocator_(), data_, capacity_);
+
+	data_ = inline_;
+	capacity_ = Inline_N;
+};
+
+
+/*
+============================================================================
+-------------------------class One_Iterator methods BEGIN-------------------------
+============================================================================
+*/
+
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator::One_Iterator(const Bitset <Chunk_T, Allocator_T, Inline_N> &bitset, const std::size_t pos) noexcept
+	:
+	bitset_(&bitset)
+{
+	if(pos >= bitset.size_)
+		return;
+
+	chunk_index_ = bitset.chunk_pos_(pos);
+	rest_ = bitset.chunks_[chunk_index_] & (set_chunk_ << bitset.bit_pos_(pos));
+
+	advance_();
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr void Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator::advance_() noexcept
+{
+	while(rest_ == zero_chunk_)
+	{
+		if(++chunk_index_ >= bitset_->chunks_.size())
+		{
+			pos_ = npos;
+			return;
+		}
+
+		rest_ = bitset_->chunks_[chunk_index_];
+	}
+
+	const std::size_t bit_pos = lowest_bit_(rest_);
+	rest_ &= ~(one_chunk_ << bit_pos);
+
+	pos_ = chunk_index_ * chunk_size_ + bit_pos;
+
+	if(pos_ >= bitset_->size_)	//unused bits might be dirty
+		pos_ = npos;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr std::size_t Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator::operator * () const noexcept
+{
+	return pos_;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator& Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator::operator ++ () noexcept
+{
+	advance_();
+
+	return *this;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator::operator ++ (int) noexcept
+{
+	One_Iterator previous = *this;
+	advance_();
+
+	return previous;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator::operator == (const One_Iterator &rhs) const noexcept
+{
+	return pos_ == rhs.pos_;
+};
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::One_Iterator::operator != (const One_Iterator &rhs) const noexcept
+{
+	return pos_ != rhs.pos_;
+};
+
 
 /*
 ============================================================================
@@ -678,8 +1644,8 @@ void Bitset <Chunk_T, Allocator_T>::set_unused_bits_(const bool value) //noexcep
 */
 
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>::Reference::Reference(Bitset <Chunk_T, Allocator_T> &target, const std::size_t pos)
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::Reference(Bitset <Chunk_T, Allocator_T, Inline_N> &target, const std::size_t pos)
 	:
 	chunk_reference_(target.chunks_[target.chunk_pos_(pos)]),
 	chunk_mask_true_(one_chunk_ << target.bit_pos_(pos)),
@@ -687,30 +1653,30 @@ constexpr Bitset <Chunk_T, Allocator_T>::Reference::Reference(Bitset <Chunk_T, A
 {};
 
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr Bitset <Chunk_T, Allocator_T>::Reference::operator bool () const noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::operator bool () const noexcept
 {
 	return chunk_reference_ & chunk_mask_true_;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Allocator_T>::Reference::operator = (const bool value) noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::Reference& Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::operator = (const bool value) noexcept
 {
 	value ? chunk_reference_ |= chunk_mask_true_ : chunk_reference_ &= chunk_mask_false_;
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Allocator_T>::Reference::operator = (const Bitset <Chunk_T, Allocator_T>::Reference& rhs) noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::Reference& Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::operator = (const Bitset <Chunk_T, Allocator_T, Inline_N>::Reference& rhs) noexcept
 {
 	rhs ? chunk_reference_ |= chunk_mask_true_ : chunk_reference_ &= chunk_mask_false_;
 
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Allocator_T>::Reference::operator &= (const bool value) noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::Reference& Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::operator &= (const bool value) noexcept
 {
 	if(!value) 
 		chunk_reference_ &= chunk_mask_false_;
@@ -718,8 +1684,8 @@ constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Al
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Allocator_T>::Reference::operator |= (const bool value) noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::Reference& Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::operator |= (const bool value) noexcept
 {
 	if(value) 
 		chunk_reference_ |= chunk_mask_true_;
@@ -727,8 +1693,8 @@ constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Al
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Allocator_T>::Reference::operator ^= (const bool value) noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr typename Bitset <Chunk_T, Allocator_T, Inline_N>::Reference& Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::operator ^= (const bool value) noexcept
 {
 	if(value)
 		chunk_reference_ ^= chunk_mask_true_;
@@ -736,11 +1702,26 @@ constexpr typename Bitset <Chunk_T, Allocator_T>::Reference& Bitset <Chunk_T, Al
 	return *this;
 };
 
-template <typename Chunk_T, typename Allocator_T>
-constexpr bool Bitset <Chunk_T, Allocator_T>::Reference::operator ~ () const noexcept
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+constexpr bool Bitset <Chunk_T, Allocator_T, Inline_N>::Reference::operator ~ () const noexcept
 {
 	return !(chunk_reference_ & chunk_mask_true_);
 };
 
 
+} //namespace end
+
+
+namespace std
+{
+
+template <typename Chunk_T, typename Allocator_T, std::size_t Inline_N>
+struct hash <bit::Bitset <Chunk_T, Allocator_T, Inline_N>>
+{
+	std::size_t operator () (const bit::Bitset <Chunk_T, Allocator_T, Inline_N> &mask) const noexcept
+	{
+		return mask.hash();
+	};
+};
+
 } //namespace end
\ No newline at end of file
@@ -0,0 +1,429 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "blob.hpp"
+
+
+namespace rgx
+{
+
+
+
+// subset construction done ahead of time, see Options::dfa_states:
+// the whole DFA is added state by state, then minimize() merges the states
+// no input can tell apart (Hopcroft) and numbers the rest, the start state 0.
+// what is left is one dense table of (id, column) -> id, read only afterwards
+class Eager_DFA
+{
+public:
+
+    using Id_T          = uint16_t;
+
+
+    static constexpr const std::size_t MAX_STATES = std::numeric_limits <Id_T>::max();
+
+
+private:
+
+
+    std::size_t m_columns = 0;
+
+    std::vector <Id_T> m_transitions;
+
+    // what next() reads: m_transitions, or the table in a borrowed blob
+    const Id_T *m_table = nullptr;
+    std::size_t m_table_size = 0;
+
+    // bit 0 accepting, bit 1 dead (no way out)
+    std::vector <uint8_t> m_flags;
+
+
+    void mark_dead() noexcept;
+
+    bool borrowed() const noexcept;
+
+
+public:
+
+    Eager_DFA() = default;
+
+    explicit Eager_DFA(const std::size_t columns);
+
+    // a copy of a borrowed table borrows it too, the vectors move with their memory
+    Eager_DFA(const Eager_DFA&);
+    Eager_DFA(Eager_DFA&&) noexcept = default;
+
+    Eager_DFA& operator = (const Eager_DFA&);
+    Eager_DFA& operator = (Eager_DFA&&) noexcept = default;
+
+
+    // every transition of the new state has to be linked before minimize()
+    Id_T add(const bool accepting);
+
+    void link(const Id_T from, const std::size_t column, const Id_T to) noexcept;
+
+    void minimize();
+
+
+    void save(Blob_Writer&) const;
+
+    // throws std::invalid_argument if what was read doesnt hold together;
+    // the table stays in the blob if the reader borrows
+    void load(Blob_Reader&);
+
+
+    Id_T next(const Id_T id, const std::size_t column) const noexcept;
+
+    bool accepting(const Id_T id) const noexcept;
+    bool dead(const Id_T id) const noexcept;
+
+
+    // no states, nothing was built
+    bool empty() const noexcept;
+
+    std::size_t size() const noexcept;
+    std::size_t columns() const noexcept;
+    std::size_t memory() const noexcept;
+};
+
+
+
+inline Eager_DFA::Eager_DFA(const std::size_t columns)
+    :
+    m_columns(columns)
+{};
+
+
+inline Eager_DFA::Eager_DFA(const Eager_DFA &rhs)
+    :
+    m_columns(rhs.m_columns),
+    m_transitions(rhs.m_transitions),
+    m_table(rhs.borrowed() ? rhs.m_table : m_transitions.data()),
+    m_table_size(rhs.m_table_size),
+    m_flags(rhs.m_flags)
+{};
+
+
+inline Eager_DFA& Eager_DFA::operator = (const Eager_DFA &rhs)
+{
+    if(this != &rhs)
+    {
+        m_columns = rhs.m_columns;
+        m_transitions = rhs.m_transitions;
+        m_table = rhs.borrowed() ? rhs.m_table : m_transitions.data();
+        m_table_size = rhs.m_table_size;
+        m_flags = rhs.m_flags;
+    }
+
+    return *this;
+};
+
+
+inline Eager_DFA::Id_T Eager_DFA::add(const bool accepting)
+{
+    const Id_T id = static_cast <Id_T>(m_flags.size());
+
+    m_flags.push_back(accepting ? 1 : 0);
+    m_transitions.resize(m_transitions.size() + m_columns, id);
+
+    m_table = m_transitions.data();
+    m_table_size = m_transitions.size();
+
+    return id;
+};
+
+
+inline void Eager_DFA::link(const Id_T from, const std::size_t column, const Id_T to) noexcept
+{
+    m_transitions[from * m_columns + column] = to;
+};
+
+
+// the states are split into blocks, accepting or not, and a block is split
+// again whenever some column takes part of it into a block (the splitter)
+// and the rest elsewhere. blocks are kept as contiguous slices of one array
+// of states; the marked states of a block are moved to the front of its slice
+inline void Eager_DFA::minimize()
+{
+    const std::size_t count = m_flags.size();
+    if(count == 0)
+    {
+        return;
+    }
+
+    struct Block
+    {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t marked;
+        bool pending;
+    };
+
+    // the states entering a state on a column, bucketed by (column, state)
+    std::vector <std::size_t> offsets(m_columns * count + 1, 0);
+    for(std::size_t from = 0; from < count; ++from)
+    {
+        for(std::size_t column = 0; column < m_columns; ++column)
+        {
+            ++offsets[column * count + next(static_cast <Id_T>(from), column) + 1];
+        }
+    }
+
+    for(std::size_t itr = 1; itr < offsets.size(); ++itr)
+    {
+        offsets[itr] += offsets[itr - 1];
+    }
+
+    std::vector <Id_T> sources(m_columns * count);
+    {
+        std::vector <std::size_t> cursors(offsets.begin(), offsets.end() - 1);
+        for(std::size_t from = 0; from < count; ++from)
+        {
+            for(std::size_t column = 0; column < m_columns; ++column)
+            {
+                sources[cursors[column * count + next(static_cast <Id_T>(from), column)]++] = static_cast <Id_T>(from);
+            }
+        }
+    }
+
+    // accepting states first
+    std::vector <Id_T> states;
+    std::vector <std::size_t> positions(count);
+    std::vector <std::size_t> block_of(count);
+    std::vector <Block> blocks;
+
+    for(const bool accepting : {true, false})
+    {
+        const std::size_t begin = states.size();
+        for(std::size_t id = 0; id < count; ++id)
+        {
+            if(this->accepting(static_cast <Id_T>(id)) == accepting)
+            {
+                positions[id] = states.size();
+                block_of[id] = blocks.size();
+                states.push_back(static_cast <Id_T>(id));
+            }
+        }
+
+        if(states.size() != begin)
+        {
+            blocks.push_back({begin, states.size(), 0, true});
+        }
+    }
+
+    std::vector <std::size_t> pending;
+    for(std::size_t block = 0; block < blocks.size(); ++block)
+    {
+        pending.push_back(block);
+    }
+
+    std::vector <Id_T> splitter;
+    std::vector <std::size_t> touched;
+
+    while(!pending.empty())
+    {
+        const std::size_t current = pending.back();
+        pending.pop_back();
+        blocks[current].pending = false;
+
+        // the block may be split while its columns are gone through
+        splitter.assign(states.begin() + blocks[current].begin, states.begin() + blocks[current].end);
+
+        for(std::size_t column = 0; column < m_columns; ++column)
+        {
+            touched.clear();
+
+            for(const Id_T target : splitter)
+            {
+                const std::size_t bucket = column * count + target;
+                for(std::size_t itr = offsets[bucket]; itr < offsets[bucket + 1]; ++itr)
+                {
+                    // a state has one transition per column, so it is marked at most once
+                    const Id_T source = sources[itr];
+                    Block &owner = blocks[block_of[source]];
+
+                    const std::size_t slot = owner.begin + owner.marked++;
+                    const Id_T moved = states[slot];
+
+                    std::swap(states[slot], states[positions[source]]);
+                    std::swap(positions[moved], positions[source]);
+
+                    if(owner.marked == 1)
+                    {
+                        touched.push_back(block_of[source]);
+                    }
+                }
+            }
+
+            for(const std::size_t index : touched)
+            {
+                const std::size_t marked = blocks[index].marked;
+                blocks[index].marked = 0;
+
+                if(blocks[index].begin + marked == blocks[index].end)
+                {
+                    continue;
+                }
+
+                // the marked front becomes a block of its own
+                const std::size_t split = blocks.size();
+                blocks.push_back({blocks[index].begin, blocks[index].begin + marked, 0, false});
+                blocks[index].begin += marked;
+
+                for(std::size_t itr = blocks[split].begin; itr < blocks[split].end; ++itr)
+                {
+                    block_of[states[itr]] = split;
+                }
+
+                // both halves are needed if the whole was, otherwise the smaller will do
+                std::size_t next_splitter = split;
+                if(!blocks[index].pending && marked > blocks[index].end - blocks[index].begin)
+                {
+                    next_splitter = index;
+                }
+
+                blocks[next_splitter].pending = true;
+                pending.push_back(next_splitter);
+            }
+        }
+    }
+
+    // one state per block, the one of the start state first
+    std::vector <Id_T> ids(blocks.size(), 0);
+    Id_T size = 1;
+    for(std::size_t block = 0; block < blocks.size(); ++block)
+    {
+        if(block != block_of[0])
+        {
+            ids[block] = size++;
+        }
+    }
+
+    std::vector <Id_T> transitions(size * m_columns);
+    std::vector <uint8_t> flags(size);
+
+    for(std::size_t block = 0; block < blocks.size(); ++block)
+    {
+        const Id_T representative = states[blocks[block].begin];
+
+        for(std::size_t column = 0; column < m_columns; ++column)
+        {
+            transitions[ids[block] * m_columns + column] = ids[block_of[next(representative, column)]];
+        }
+
+        flags[ids[block]] = m_flags[representative];
+    }
+
+    m_transitions = std::move(transitions);
+    m_flags = std::move(flags);
+
+    m_table = m_transitions.data();
+    m_table_size = m_transitions.size();
+
+    mark_dead();
+};
+
+
+// a rejecting state that only leads back to itself
+inline void Eager_DFA::mark_dead() noexcept
+{
+    for(std::size_t id = 0; id < m_flags.size(); ++id)
+    {
+        bool dead = !(m_flags[id] & 1);
+        for(std::size_t column = 0; dead && column < m_columns; ++column)
+        {
+            dead = next(static_cast <Id_T>(id), column) == id;
+        }
+
+        if(dead)
+        {
+            m_flags[id] |= 2;
+        }
+    }
+};
+
+
+inline void Eager_DFA::save(Blob_Writer &writer) const
+{
+    writer.write(m_columns);
+    writer.write_array(m_table, m_table_size);
+    writer.write_array(m_flags.data(), m_flags.size());
+};
+
+
+inline void Eager_DFA::load(Blob_Reader &reader)
+{
+    m_columns = reader.read_size();
+    m_table = reader.read_array(m_transitions, m_table_size);
+    reader.read_array(m_flags);
+
+    if(m_flags.size() > MAX_STATES || m_table_size / (m_columns ? m_columns : 1) != m_flags.size()
+        || m_table_size != m_flags.size() * m_columns)
+    {
+        Blob_Reader::malformed();
+    }
+
+    for(const Id_T *id = m_table; id != m_table + m_table_size; ++id)
+    {
+        if(*id >= m_flags.size())
+        {
+            Blob_Reader::malformed();
+        }
+    }
+};
+
+
+inline bool Eager_DFA::borrowed() const noexcept
+{
+    return m_table != m_transitions.data();
+};
+
+
+inline Eager_DFA::Id_T Eager_DFA::next(const Id_T id, const std::size_t column) const noexcept
+{
+    return m_table[id * m_columns + column];
+};
+
+
+inline bool Eager_DFA::accepting(const Id_T id) const noexcept
+{
+    return m_flags[id] & 1;
+};
+
+
+inline bool Eager_DFA::dead(const Id_T id) const noexcept
+{
+    return m_flags[id] & 2;
+};
+
+
+inline bool Eager_DFA::empty() const noexcept
+{
+    return m_flags.empty();
+};
+
+
+inline std::size_t Eager_DFA::size() const noexcept
+{
+    return m_flags.size();
+};
+
+
+inline std::size_t Eager_DFA::columns() const noexcept
+{
+    return m_columns;
+};
+
+
+inline std::size_t Eager_DFA::memory() const noexcept
+{
+    return m_table_size * sizeof(Id_T) + m_flags.size();
+};
+
+
+
+}
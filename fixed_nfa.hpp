@@ -0,0 +1,329 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+
+
+namespace rgx
+{
+
+
+
+// the bitset NFA squeezed into Words machine words per state set,
+// for patterns with at most 64 * Words - 1 positions (bit 0 is the
+// accepting flag); state sets live on the stack, stepping never allocates
+template <std::size_t Words>
+class Fixed_NFA
+{
+public:
+
+    using Set_T         = std::array <uint64_t, Words>;
+
+
+    static constexpr const std::size_t CAPACITY = 64 * Words;
+
+
+private:
+
+
+    // m_follow[0] is the start set, same layout as Regex::m_NFA
+    std::vector <Set_T> m_follow;
+
+    // same layout as Regex::m_char_masks
+    std::vector <Set_T> m_masks;
+
+
+    template <typename Bitset_T>
+    static Set_T convert(const Bitset_T&) noexcept;
+
+    static std::size_t lowest_bit(const uint64_t) noexcept;
+
+
+public:
+
+    template <typename Bitset_T>
+    Fixed_NFA(const std::vector <Bitset_T> &follow, const std::vector <Bitset_T> &masks);
+
+
+    void start(Set_T&) const noexcept;
+
+    Set_T empty() const noexcept;
+
+    void clear(Set_T&) const noexcept;
+
+    // state |= start states
+    void restart(Set_T&) const noexcept;
+
+    // to = union of the follow sets of (from & B[symbol])
+    void step(const Set_T &from, const std::size_t symbol, Set_T &to) const noexcept;
+
+
+    // tagged flavour used by the unanchored search: every state carries the
+    // smallest offset it was started from and passes it on to its follow set
+
+    // adds the start states missing from state, tagged with tag
+    void inject(Set_T &state, std::size_t *tags, const std::size_t tag) const noexcept;
+
+    // accept is lowered to the smallest tag reaching the accepting flag
+    void step(
+        const Set_T &from, const std::size_t *from_tags, const std::size_t symbol,
+        Set_T &to, std::size_t *to_tags, std::size_t &accept
+    ) const noexcept;
+
+    // drops the states tagged past limit
+    static void prune(Set_T &state, const std::size_t *tags, const std::size_t limit) noexcept;
+
+    static bool accepting(const Set_T&) noexcept;
+    static bool dead(const Set_T&) noexcept;
+
+};
+
+
+
+template <std::size_t Words>
+template <typename Bitset_T>
+Fixed_NFA <Words>::Fixed_NFA(const std::vector <Bitset_T> &follow, const std::vector <Bitset_T> &masks)
+{
+    m_follow.reserve(follow.size());
+    for(const Bitset_T &state : follow)
+    {
+        m_follow.push_back(convert(state));
+    }
+
+    m_masks.reserve(masks.size());
+    for(const Bitset_T &mask : masks)
+    {
+        m_masks.push_back(convert(mask));
+    }
+};
+
+
+template <std::size_t Words>
+void Fixed_NFA <Words>::start(Set_T &state) const noexcept
+{
+    state = m_follow[0];
+};
+
+
+template <std::size_t Words>
+typename Fixed_NFA <Words>::Set_T
+Fixed_NFA <Words>::empty() const noexcept
+{
+    return Set_T{};
+};
+
+
+template <std::size_t Words>
+void Fixed_NFA <Words>::clear(Set_T &state) const noexcept
+{
+    state.fill(0);
+};
+
+
+template <std::size_t Words>
+void Fixed_NFA <Words>::restart(Set_T &state) const noexcept
+{
+    for(std::size_t word = 0; word < Words; ++word)
+    {
+        state[word] |= m_follow[0][word];
+    }
+};
+
+
+template <std::size_t Words>
+void Fixed_NFA <Words>::step(const Set_T &from, const std::size_t symbol, Set_T &to) const noexcept
+{
+    const Set_T &mask = m_masks[symbol];
+
+    to.fill(0);
+
+    for(std::size_t word = 0; word < Words; ++word)
+    {
+        uint64_t active = from[word] & mask[word];
+
+        // bit 0 is the accepting flag, not a state
+        if(word == 0)
+        {
+            active &= ~uint64_t(1);
+        }
+
+        while(active)
+        {
+            const Set_T &follow = m_follow[word * 64 + lowest_bit(active)];
+
+            for(std::size_t itr = 0; itr < Words; ++itr)
+            {
+                to[itr] |= follow[itr];
+            }
+
+            active &= active - 1;    // drop the lowest set bit
+        }
+    }
+};
+
+
+template <std::size_t Words>
+void Fixed_NFA <Words>::inject(Set_T &state, std::size_t *tags, const std::size_t tag) const noexcept
+{
+    const Set_T &start = m_follow[0];
+
+    for(std::size_t word = 0; word < Words; ++word)
+    {
+        uint64_t fresh = start[word] & ~state[word];
+
+        // the nullable flag is not a state
+        if(word == 0)
+        {
+            fresh &= ~uint64_t(1);
+        }
+
+        state[word] |= fresh;
+
+        for(; fresh; fresh &= fresh - 1)
+        {
+            tags[word * 64 + lowest_bit(fresh)] = tag;
+        }
+    }
+};
+
+
+template <std::size_t Words>
+void Fixed_NFA <Words>::step(
+    const Set_T &from, const std::size_t *from_tags, const std::size_t symbol,
+    Set_T &to, std::size_t *to_tags, std::size_t &accept
+) const noexcept
+{
+    const Set_T &mask = m_masks[symbol];
+
+    to.fill(0);
+
+    for(std::size_t word = 0; word < Words; ++word)
+    {
+        uint64_t active = from[word] & mask[word];
+
+        if(word == 0)
+        {
+            active &= ~uint64_t(1);
+        }
+
+        for(; active; active &= active - 1)
+        {
+            const std::size_t pos = word * 64 + lowest_bit(active);
+            const std::size_t tag = from_tags[pos];
+            const Set_T &follow = m_follow[pos];
+
+            if((follow[0] & 1) && tag < accept)
+            {
+                accept = tag;
+            }
+
+            for(std::size_t itr = 0; itr < Words; ++itr)
+            {
+                uint64_t bits = follow[itr];
+                if(itr == 0)
+                {
+                    bits &= ~uint64_t(1);
+                }
+
+                // states reached for the first time take the tag as is,
+                // the others keep the smaller one
+                uint64_t fresh = bits & ~to[itr];
+                uint64_t seen = bits & to[itr];
+
+                to[itr] |= fresh;
+
+                for(; fresh; fresh &= fresh - 1)
+                {
+                    to_tags[itr * 64 + lowest_bit(fresh)] = tag;
+                }
+
+                for(; seen; seen &= seen - 1)
+                {
+                    std::size_t &to_tag = to_tags[itr * 64 + lowest_bit(seen)];
+                    if(tag < to_tag)
+                    {
+                        to_tag = tag;
+                    }
+                }
+            }
+        }
+    }
+};
+
+
+template <std::size_t Words>
+void Fixed_NFA <Words>::prune(Set_T &state, const std::size_t *tags, const std::size_t limit) noexcept
+{
+    for(std::size_t word = 0; word < Words; ++word)
+    {
+        for(uint64_t bits = state[word]; bits; bits &= bits - 1)
+        {
+            const std::size_t bit = lowest_bit(bits);
+
+            if(tags[word * 64 + bit] > limit)
+            {
+                state[word] &= ~(uint64_t(1) << bit);
+            }
+        }
+    }
+};
+
+
+template <std::size_t Words>
+bool Fixed_NFA <Words>::accepting(const Set_T &state) noexcept
+{
+    return state[0] & 1;
+};
+
+
+template <std::size_t Words>
+bool Fixed_NFA <Words>::dead(const Set_T &state) noexcept
+{
+    for(const uint64_t word : state)
+    {
+        if(word)
+        {
+            return false;
+        }
+    }
+
+    return true;
+};
+
+
+template <std::size_t Words>
+template <typename Bitset_T>
+typename Fixed_NFA <Words>::Set_T
+Fixed_NFA <Words>::convert(const Bitset_T &state) noexcept
+{
+    Set_T words{};
+
+    for(const std::size_t itr : state.ones())
+    {
+        words[itr / 64] |= uint64_t(1) << (itr % 64);
+    }
+
+    return words;
+};
+
+
+template <std::size_t Words>
+std::size_t Fixed_NFA <Words>::lowest_bit(const uint64_t word) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    std::size_t bit = 0;
+    while(!(word & (uint64_t(1) << bit)))
+    {
+        ++bit;
+    }
+
+    return bit;
+#endif
+};
+
+
+
+}
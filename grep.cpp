@@ -0,0 +1,328 @@
+#include "regex.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <optional>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RGX_GREP_MMAP
+#endif
+
+
+
+// usage: grep [-c] [-s] [-j N] PATTERN FILE...
+//        grep [-c] [-s] [-j N] -f COMPILED FILE...
+//        grep -o COMPILED PATTERN
+//   prints file:line:offset:line for every line holding a match,
+//   offset being the byte offset of the first match on that line
+//   -c  only print the number of matches of every file
+//   -s  print the bytes per second of the whole run to stderr
+//   -j  search every file on N threads (0 for one per core)
+//   -o  compile PATTERN into the file COMPILED and stop
+//   -f  take the pattern compiled by -o from COMPILED, used where it is
+//       mapped, without parsing, compiling or copying its tables
+
+
+
+// read only view of a whole file, mapped when possible
+class Mapped_File
+{
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+
+#ifdef RGX_GREP_MMAP
+    void *m_mapping = nullptr;
+#else
+    std::string m_buffer;
+#endif
+
+public:
+
+    explicit Mapped_File(const std::string &path)
+    {
+#ifdef RGX_GREP_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+        {
+            throw std::runtime_error("cant open " + path);
+        }
+
+        struct stat info;
+        if(::fstat(fd, &info) < 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("cant stat " + path);
+        }
+
+        m_size = static_cast <std::size_t>(info.st_size);
+
+        // mmap refuses empty mappings
+        if(m_size)
+        {
+            m_mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(m_mapping == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("cant map " + path);
+            }
+
+            ::madvise(m_mapping, m_size, MADV_SEQUENTIAL);
+
+            m_data = static_cast <const char*>(m_mapping);
+        }
+
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        if(!file)
+        {
+            throw std::runtime_error("cant open " + path);
+        }
+
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        m_buffer = buffer.str();
+
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#endif
+    };
+
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator = (const Mapped_File&) = delete;
+
+    ~Mapped_File()
+    {
+#ifdef RGX_GREP_MMAP
+        if(m_mapping)
+        {
+            ::munmap(m_mapping, m_size);
+        }
+#endif
+    };
+
+    std::string_view view() const noexcept
+    {
+        return std::string_view(m_data, m_size);
+    };
+};
+
+
+
+// returns the number of matches in text
+std::size_t grep(
+    const rgx::Regex<> &regex, rgx::Regex<>::Context &context, const std::size_t threads,
+    const std::string &path, const std::string_view text, const bool count_only, std::ostream &out
+)
+{
+    // line of the last match, counted incrementally
+    std::size_t line = 1;
+    std::size_t line_begin = 0;
+    std::size_t counted = 0;
+
+    // the last line printed, one line is printed once
+    std::size_t printed = static_cast <std::size_t>(-1);
+
+    const auto report = [&](const std::size_t begin)
+    {
+        for(const char *itr = text.data() + counted, *last = text.data() + begin;
+            (itr = static_cast <const char*>(std::memchr(itr, '\n', last - itr))); ++itr)
+        {
+            ++line;
+            line_begin = itr - text.data() + 1;
+        }
+        counted = begin;
+
+        if(line == printed)
+        {
+            return;
+        }
+        printed = line;
+
+        std::size_t line_end = text.find('\n', begin);
+        if(line_end == std::string_view::npos)
+        {
+            line_end = text.size();
+        }
+
+        out << path << ':' << line << ':' << begin << ':' << text.substr(line_begin, line_end - line_begin) << '\n';
+    };
+
+    if(threads != 1)
+    {
+        const std::vector <rgx::Match> matches = regex.parallel_search(text, threads);
+
+        if(!count_only)
+        {
+            for(const rgx::Match &match : matches)
+            {
+                report(match.begin);
+            }
+        }
+
+        return matches.size();
+    }
+
+    return regex.search_each(text, [&](const std::size_t begin, const std::size_t)
+    {
+        if(!count_only)
+        {
+            report(begin);
+        }
+    }, context);
+};
+
+
+
+int main(int argc, char *argv[])
+{
+    bool count_only = false;
+    bool stats = false;
+    std::size_t threads = 1;
+    const char *compile_to = nullptr;
+    const char *compiled = nullptr;
+
+    int arg = 1;
+    for(; arg < argc && argv[arg][0] == '-' && argv[arg][1]; ++arg)
+    {
+        if(!std::strcmp(argv[arg], "-c"))
+        {
+            count_only = true;
+        }
+        else if(!std::strcmp(argv[arg], "-s"))
+        {
+            stats = true;
+        }
+        else if(!std::strcmp(argv[arg], "-j") && arg + 1 < argc)
+        {
+            threads = std::strtoul(argv[++arg], nullptr, 10);
+        }
+        else if(!std::strcmp(argv[arg], "-o") && arg + 1 < argc)
+        {
+            compile_to = argv[++arg];
+        }
+        else if(!std::strcmp(argv[arg], "-f") && arg + 1 < argc)
+        {
+            compiled = argv[++arg];
+        }
+        else
+        {
+            std::cerr << "unknown option " << argv[arg] << std::endl;
+            return 2;
+        }
+    }
+
+    if(compile_to ? argc - arg != 1 : argc - arg < (compiled ? 1 : 2))
+    {
+        std::cerr << "usage: " << argv[0] << " [-c] [-s] [-j N] PATTERN FILE..." << std::endl;
+        std::cerr << "       " << argv[0] << " [-c] [-s] [-j N] -f COMPILED FILE..." << std::endl;
+        std::cerr << "       " << argv[0] << " -o COMPILED PATTERN" << std::endl;
+        return 2;
+    }
+
+    if(compile_to)
+    {
+        std::ofstream file(compile_to, std::ios::binary);
+
+        try
+        {
+            file << rgx::Regex<>(argv[arg]).save(rgx::Blob::MAPPED);
+        }
+        catch(const std::exception &error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 2;
+        }
+
+        if(!file.flush())
+        {
+            std::cerr << "cant write " << compile_to << std::endl;
+            return 2;
+        }
+
+        return 0;
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    // the regex views the mapping, which goes away after it
+    std::optional <const Mapped_File> compiled_file;
+    std::optional <const rgx::Regex<>> regex;
+    try
+    {
+        if(compiled)
+        {
+            compiled_file.emplace(compiled);
+            regex.emplace(rgx::Regex<>::view(compiled_file->view()));
+        }
+        else
+        {
+            regex.emplace(argv[arg++]);
+        }
+    }
+    catch(const std::exception &error)
+    {
+        std::cerr << error.what() << std::endl;
+        return 2;
+    }
+
+    rgx::Regex<>::Context context(*regex);
+
+    std::size_t bytes = 0;
+    std::size_t matches = 0;
+    bool failed = false;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for(; arg < argc; ++arg)
+    {
+        try
+        {
+            const Mapped_File file(argv[arg]);
+
+            const std::size_t count = grep(*regex, context, threads, argv[arg], file.view(), count_only, std::cout);
+
+            if(count_only)
+            {
+                std::cout << argv[arg] << ':' << count << '\n';
+            }
+
+            bytes += file.view().size();
+            matches += count;
+        }
+        catch(const std::exception &error)
+        {
+            std::cerr << error.what() << std::endl;
+            failed = true;
+        }
+    }
+
+    std::cout.flush();
+
+    if(stats)
+    {
+        const std::chrono::duration <double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cerr << bytes << " bytes, " << matches << " matches in " << elapsed.count() << " s, "
+            << (elapsed.count() > 0 ? bytes / elapsed.count() / (1 << 20) : 0) << " MiB/s" << std::endl;
+    }
+
+    if(failed)
+    {
+        return 2;
+    }
+
+    return matches ? 0 : 1;
+};
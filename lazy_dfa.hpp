@@ -0,0 +1,202 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <climits>
+#include <limits>
+
+
+namespace rgx
+{
+
+
+
+// subset construction done on demand:
+// every distinct state set met while simulating is interned into an id,
+// transitions (id, column) -> id are cached in a dense table
+template <typename State_T>
+class Lazy_DFA
+{
+public:
+
+    using Id_T          = uint32_t;
+
+
+    static constexpr const Id_T UNKNOWN = std::numeric_limits <Id_T>::max();
+
+
+private:
+
+
+    std::size_t m_columns;
+
+    // upper bound (in bytes) for the whole cache, see memory()
+    std::size_t m_limit;
+
+    std::size_t m_memory;
+
+
+    // the keys of m_ids are node based, so pointers to them stay valid
+    std::unordered_map <State_T, Id_T> m_ids;
+    std::vector <const State_T*> m_states;
+
+    std::vector <Id_T> m_transitions;
+
+    // bit 0 accepting, bit 1 dead (no way out)
+    std::vector <uint8_t> m_flags;
+
+
+    std::size_t state_cost(const State_T&) const noexcept;
+
+
+public:
+
+    Lazy_DFA(const std::size_t columns, const std::size_t limit);
+
+
+    // UNKNOWN if the state is new and would not fit in the memory limit
+    Id_T intern(const State_T &state);
+
+    Id_T next(const Id_T id, const std::size_t column) const noexcept;
+
+    void link(const Id_T from, const std::size_t column, const Id_T to) noexcept;
+
+    void flush() noexcept;
+
+
+    const State_T& state(const Id_T id) const noexcept;
+
+    bool accepting(const Id_T id) const noexcept;
+    bool dead(const Id_T id) const noexcept;
+
+
+    std::size_t size() const noexcept;
+    std::size_t memory() const noexcept;
+    std::size_t limit() const noexcept;
+
+};
+
+
+
+template <typename State_T>
+Lazy_DFA <State_T>::Lazy_DFA(const std::size_t columns, const std::size_t limit)
+    :
+    m_columns(columns),
+    m_limit(limit),
+    m_memory(0)
+{};
+
+
+template <typename State_T>
+typename Lazy_DFA <State_T>::Id_T
+Lazy_DFA <State_T>::intern(const State_T &state)
+{
+    const auto found = m_ids.find(state);
+    if(found != m_ids.end())
+    {
+        return found->second;
+    }
+
+    const std::size_t cost = state_cost(state);
+    if(m_memory + cost > m_limit || m_states.size() >= UNKNOWN)
+    {
+        return UNKNOWN;
+    }
+
+    const Id_T id = static_cast <Id_T>(m_states.size());
+    const auto inserted = m_ids.emplace(state, id).first;
+
+    m_states.push_back(&inserted->first);
+    m_flags.push_back((state.test(0) ? 1 : 0) | (state.none() ? 2 : 0));
+    m_transitions.resize(m_transitions.size() + m_columns, UNKNOWN);
+
+    m_memory += cost;
+
+    return id;
+};
+
+
+template <typename State_T>
+typename Lazy_DFA <State_T>::Id_T
+Lazy_DFA <State_T>::next(const Id_T id, const std::size_t column) const noexcept
+{
+    return m_transitions[id * m_columns + column];
+};
+
+
+template <typename State_T>
+void Lazy_DFA <State_T>::link(const Id_T from, const std::size_t column, const Id_T to) noexcept
+{
+    m_transitions[from * m_columns + column] = to;
+};
+
+
+// keeps the allocated memory around, only the states are dropped
+template <typename State_T>
+void Lazy_DFA <State_T>::flush() noexcept
+{
+    m_ids.clear();
+    m_states.clear();
+    m_flags.clear();
+    m_transitions.clear();
+
+    m_memory = 0;
+};
+
+
+template <typename State_T>
+const State_T& Lazy_DFA <State_T>::state(const Id_T id) const noexcept
+{
+    return *m_states[id];
+};
+
+
+template <typename State_T>
+bool Lazy_DFA <State_T>::accepting(const Id_T id) const noexcept
+{
+    return m_flags[id] & 1;
+};
+
+
+template <typename State_T>
+bool Lazy_DFA <State_T>::dead(const Id_T id) const noexcept
+{
+    return m_flags[id] & 2;
+};
+
+
+template <typename State_T>
+std::size_t Lazy_DFA <State_T>::size() const noexcept
+{
+    return m_states.size();
+};
+
+
+template <typename State_T>
+std::size_t Lazy_DFA <State_T>::memory() const noexcept
+{
+    return m_memory;
+};
+
+
+template <typename State_T>
+std::size_t Lazy_DFA <State_T>::limit() const noexcept
+{
+    return m_limit;
+};
+
+
+// rough estimate: one table row, the bits of the state and a hash node
+template <typename State_T>
+std::size_t Lazy_DFA <State_T>::state_cost(const State_T &state) const noexcept
+{
+    return m_columns * sizeof(Id_T)
+        + state.size() / CHAR_BIT + sizeof(State_T)
+        + sizeof(typename decltype(m_ids)::value_type) + 2 * sizeof(void*)
+        + sizeof(const State_T*) + sizeof(uint8_t);
+};
+
+
+
+}
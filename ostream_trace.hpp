@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+#include "trace.hpp"
+
+
+namespace rgx
+{
+
+
+
+// writes everything to std::cout, the way Regex used to
+struct Ostream_Trace
+{
+    template <typename Exp_T, typename Labels_T>
+    static void compiled(const Exp_T &postfix, const Labels_T &labels)
+    {
+        for(const auto &chr : postfix)
+        {
+            std::cout << chr.first;
+        }
+        std::cout << std::endl;
+
+        for(const auto &chr : postfix)
+        {
+            std::cout << static_cast <unsigned int>(chr.second) << ' ';
+        }
+        std::cout << std::endl;
+
+        for(const auto &label : labels)
+        {
+            std::cout << label.first;
+        }
+        std::cout << std::endl;
+    };
+
+    template <typename String_T>
+    static void matched(const String_T &word, const bool result)
+    {
+        print(word, 0, word.size());
+        std::cout << (result ? " matches" : " does not match") << std::endl;
+    };
+
+    template <typename String_T>
+    static void found(const String_T &sample, const std::size_t begin, const std::size_t end)
+    {
+        std::cout << "Found: \"";
+        print(sample, begin, end);
+        std::cout << "\" at index " << begin << std::endl;
+    };
+
+    template <typename String_T>
+    static void searched(const String_T&, const std::size_t count)
+    {
+        if(count == 0)
+        {
+            std::cout << "No matches." << std::endl;
+        }
+        else
+        {
+            std::cout << "Found a total of " << count << " matches." << std::endl;
+        }
+    };
+
+private:
+
+    // samples are string views or iterator ranges, only indexing is common
+    template <typename String_T>
+    static void print(const String_T &sample, const std::size_t begin, const std::size_t end)
+    {
+        for(std::size_t itr = begin; itr < end; ++itr)
+        {
+            std::cout << sample[itr];
+        }
+    };
+};
+
+
+
+}
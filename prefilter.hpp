@@ -0,0 +1,288 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+namespace rgx
+{
+
+
+
+// finds where a match of a byte pattern may start without running the automaton:
+// at the next occurrence of the literal every match begins with, or at the next
+// byte some match begins with. also tells whether the literal every match
+// contains occurs at all, so a search can stop early.
+// all scans are memchr or SIMD compares, 16 or 32 bytes at a time
+class Prefilter
+{
+public:
+
+    using Table_T       = std::array <bool, std::size_t(1) << CHAR_BIT>;
+    using Literal_T     = std::string;    // raw bytes
+
+
+    // bytes scanned for side by side, more of them go through the table
+    static constexpr const std::size_t MAX_BYTES = 4;
+
+
+private:
+
+
+    enum class Kind : uint8_t
+    {
+        NONE,       // every byte may start a match, nothing to skip
+        BYTES,      // m_bytes
+        TABLE       // m_table
+    };
+
+
+    Kind m_kind = Kind::NONE;
+
+    Table_T m_table{};
+
+    unsigned char m_bytes[MAX_BYTES] = {};
+    std::size_t m_byte_count = 0;
+
+    Literal_T m_prefix;
+    Literal_T m_required;
+
+
+    std::size_t find_bytes(const unsigned char*, const std::size_t, std::size_t) const noexcept;
+    std::size_t find_table(const unsigned char*, const std::size_t, std::size_t) const noexcept;
+
+    static std::size_t find_literal(const unsigned char*, const std::size_t, std::size_t, const Literal_T&) noexcept;
+
+    static std::size_t lowest_bit(const uint32_t) noexcept;
+
+
+public:
+
+    Prefilter() = default;
+
+    // starts: the bytes a match can begin with,
+    // prefix: the literal every match begins with,
+    // required: the literal every match contains, both may be empty
+    Prefilter(const Table_T &starts, Literal_T prefix, Literal_T required);
+
+
+    // the first offset from from on holding a byte a match may start with,
+    // size if there is none
+    std::size_t find_start(const unsigned char *data, const std::size_t size, const std::size_t from) const noexcept;
+
+    // the first occurrence of the prefix from from on, size if there is none
+    std::size_t find_prefix(const unsigned char *data, const std::size_t size, const std::size_t from) const noexcept;
+
+    // false if no match can start at from or later
+    bool viable(const unsigned char *data, const std::size_t size, const std::size_t from) const noexcept;
+
+    // only worth looking for when longer than the one byte find_start finds anyway
+    std::size_t prefix_size() const noexcept { return m_prefix.size() > 1 ? m_prefix.size() : 0; };
+};
+
+
+
+inline Prefilter::Prefilter(const Table_T &starts, Literal_T prefix, Literal_T required)
+    :
+    m_table(starts),
+    m_prefix(std::move(prefix)),
+    m_required(std::move(required))
+{
+    for(std::size_t itr = 0; itr < m_table.size(); ++itr)
+    {
+        if(m_table[itr] && m_byte_count++ < MAX_BYTES)
+        {
+            m_bytes[m_byte_count - 1] = static_cast <unsigned char>(itr);
+        }
+    }
+
+    if(m_byte_count <= MAX_BYTES)
+    {
+        m_kind = Kind::BYTES;
+    }
+    else if(m_byte_count < m_table.size())
+    {
+        m_kind = Kind::TABLE;
+    }
+
+    // the prefix is looked for anyway
+    if(m_required == m_prefix)
+    {
+        m_required.clear();
+    }
+};
+
+
+inline std::size_t Prefilter::find_start(const unsigned char *data, const std::size_t size, const std::size_t from) const noexcept
+{
+    if(from >= size)
+    {
+        return size;
+    }
+
+    switch(m_kind)
+    {
+        case Kind::BYTES:
+            return find_bytes(data, size, from);
+        case Kind::TABLE:
+            return find_table(data, size, from);
+        default:
+            return from;
+    }
+};
+
+
+inline std::size_t Prefilter::find_prefix(const unsigned char *data, const std::size_t size, const std::size_t from) const noexcept
+{
+    return find_literal(data, size, from, m_prefix);
+};
+
+
+inline bool Prefilter::viable(const unsigned char *data, const std::size_t size, const std::size_t from) const noexcept
+{
+    return m_required.empty() || find_literal(data, size, from, m_required) != size;
+};
+
+
+inline std::size_t Prefilter::find_bytes(const unsigned char *data, const std::size_t size, std::size_t from) const noexcept
+{
+    // no match at all, every offset is ruled out
+    if(m_byte_count == 0)
+    {
+        return size;
+    }
+
+    if(m_byte_count == 1)
+    {
+        const void *found = std::memchr(data + from, m_bytes[0], size - from);
+
+        return found ? static_cast <const unsigned char*>(found) - data : size;
+    }
+
+#if defined(__AVX2__)
+    __m256i needles[MAX_BYTES];
+    for(std::size_t itr = 0; itr < m_byte_count; ++itr)
+    {
+        needles[itr] = _mm256_set1_epi8(static_cast <char>(m_bytes[itr]));
+    }
+
+    for(; from + 32 <= size; from += 32)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast <const __m256i*>(data + from));
+
+        __m256i hits = _mm256_cmpeq_epi8(block, needles[0]);
+        for(std::size_t itr = 1; itr < m_byte_count; ++itr)
+        {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[itr]));
+        }
+
+        if(const uint32_t mask = static_cast <uint32_t>(_mm256_movemask_epi8(hits)))
+        {
+            return from + lowest_bit(mask);
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i needles[MAX_BYTES];
+    for(std::size_t itr = 0; itr < m_byte_count; ++itr)
+    {
+        needles[itr] = _mm_set1_epi8(static_cast <char>(m_bytes[itr]));
+    }
+
+    for(; from + 16 <= size; from += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast <const __m128i*>(data + from));
+
+        __m128i hits = _mm_cmpeq_epi8(block, needles[0]);
+        for(std::size_t itr = 1; itr < m_byte_count; ++itr)
+        {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[itr]));
+        }
+
+        if(const uint32_t mask = static_cast <uint32_t>(_mm_movemask_epi8(hits)))
+        {
+            return from + lowest_bit(mask);
+        }
+    }
+#endif
+
+    // the tail, or everything without SIMD
+    return find_table(data, size, from);
+};
+
+
+inline std::size_t Prefilter::find_table(const unsigned char *data, const std::size_t size, std::size_t from) const noexcept
+{
+    while(from < size && !m_table[data[from]])
+    {
+        ++from;
+    }
+
+    return from;
+};
+
+
+// memchr for the first byte, then compare the rest
+inline std::size_t Prefilter::find_literal(
+    const unsigned char *data, const std::size_t size, std::size_t from, const Literal_T &literal
+) noexcept
+{
+    if(literal.empty())
+    {
+        return from;
+    }
+
+    if(literal.size() > size)
+    {
+        return size;
+    }
+
+    const std::size_t last = size - literal.size();
+
+    while(from <= last)
+    {
+        const void *found = std::memchr(data + from, static_cast <unsigned char>(literal[0]), last - from + 1);
+        if(!found)
+        {
+            break;
+        }
+
+        from = static_cast <const unsigned char*>(found) - data;
+
+        if(!std::memcmp(data + from + 1, literal.data() + 1, literal.size() - 1))
+        {
+            return from;
+        }
+
+        ++from;
+    }
+
+    return size;
+};
+
+
+inline std::size_t Prefilter::lowest_bit(const uint32_t word) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(word);
+#else
+    std::size_t bit = 0;
+    while(!(word & (uint32_t(1) << bit)))
+    {
+        ++bit;
+    }
+
+    return bit;
+#endif
+};
+
+
+
+}
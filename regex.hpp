@@ -2,18 +2,30 @@
 
 #include <vector>
 #include <bitset>
-#include <iostream>
-#include <fstream>
 #include <string>
+#include <string_view>
 #include <cctype>
 #include <locale>
 #include <stdexcept>
 #include <stack>
 #include <cstdint>
-#include <list>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <variant>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
+#include <memory_resource>
 
 #include "dynamic_bitset.hpp"
+#include "lazy_dfa.hpp"
+#include "eager_dfa.hpp"
+#include "fixed_nfa.hpp"
+#include "trace.hpp"
+#include "prefilter.hpp"
+#include "blob.hpp"
 
 
 
@@ -22,16 +34,179 @@ namespace rgx
 
 
 
-template <typename String_T = std::string>
+template <typename>
+class RegexSet;
+
+
+
+struct Options
+{
+    // also build the reversed automaton: search then finds match ends with a
+    // forward scan and match starts with a backward one, instead of tagging
+    // every state with its start offset.
+    // patterns that keep a chain (a counted repetition of one character or
+    // class, in a pattern too large for the fixed width engines, see
+    // Regex::m_exits) ignore it and search with tags: the reverse of a chain
+    // is no chain
+    bool reverse_search = false;
+
+    // memory cap (in bytes) of the lazily built DFA used by match(),
+    // once reached the cache is flushed and the bitset NFA takes over,
+    // 0 disables the DFA altogether
+    std::size_t dfa_cache_limit = std::size_t(1) << 21;
+
+    // build the whole DFA at construction, minimized, if subset construction
+    // gets by with at most this many states (Eager_DFA::MAX_STATES at most);
+    // match() is then a table lookup per character and needs no context.
+    // past the budget the pattern runs as if it was 0, which never builds it
+    std::size_t dfa_states = 0;
+
+    // smallest piece of input parallel_search hands to a thread
+    std::size_t parallel_chunk = std::size_t(1) << 16;
+};
+
+
+
+// a match found by search, as [begin, end) offsets into the input
+struct Match
+{
+    std::size_t begin;
+    std::size_t end;
+};
+
+
+
+// a random access iterator pair, indexed the same way as a string_view
+template <typename Iterator_T>
+class Sample_Range
+{
+    Iterator_T m_first;
+    Iterator_T m_last;
+
+public:
+
+    Sample_Range(const Iterator_T first, const Iterator_T last)
+        :
+        m_first(first),
+        m_last(last)
+    {
+        static_assert(
+            std::is_base_of <
+                std::random_access_iterator_tag, typename std::iterator_traits <Iterator_T>::iterator_category
+            >::value,
+            "Sample_Range needs random access iterators"
+        );
+    };
+
+    Iterator_T begin() const { return m_first; };
+    Iterator_T end() const { return m_last; };
+
+    std::size_t size() const { return static_cast <std::size_t>(m_last - m_first); };
+
+    decltype(auto) operator [] (const std::size_t pos) const { return m_first[pos]; };
+};
+
+
+
+// tells the objects a context was built for apart: unique for the whole
+// process, also from an object since destroyed at the same address, and
+// taken anew by every copy, so a context never outlives the tables it holds
+class Identity
+{
+    uint64_t m_value;
+
+    static uint64_t next() noexcept
+    {
+        static std::atomic <uint64_t> counter(0);
+
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    };
+
+public:
+
+    // 0, no object has it
+    static constexpr const uint64_t NONE = 0;
+
+    Identity() noexcept : m_value(next()) {};
+    Identity(const Identity&) noexcept : m_value(next()) {};
+
+    Identity& operator = (const Identity&) noexcept { m_value = next(); return *this; };
+
+    uint64_t value() const noexcept { return m_value; };
+};
+
+
+
+template <typename String_T = std::string, typename Trace_T = No_Trace>
 class Regex
 {
+    // reads the compiled tables of its patterns
+    template <typename> friend class RegexSet;
+
     using Char_T        = typename String_T::value_type;
     using Traits_T      = typename String_T::traits_type;
     using Alloc_T       = typename String_T::allocator_type;
-    using Exp_value_T   = typename std::pair <Char_T, uint8_t>;
+    struct Exp_value_T;
     using Exp_T         = typename std::vector <Exp_value_T>;
     using State_T       = typename bit::Bitset <uint64_t>;
     using NFA_T         = typename std::vector <State_T>;
+    using DFA_T         = Lazy_DFA <State_T>;
+    using View_T        = typename std::basic_string_view <Char_T, Traits_T>;
+    using Literal_T     = typename std::basic_string <Char_T, Traits_T>;
+
+    // construction scratch (the expressions between the parsing passes, the
+    // First/Last stacks, the mask tables) comes from one arena per constructor
+    // call and is dropped with it in one go. the sets themselves stay State_T:
+    // up to 255 positions they are inline anyway, past that they are moved
+    // into m_NFA and m_char_masks instead of being copied out of the arena
+    using Arena_T       = std::pmr::monotonic_buffer_resource;
+    using Scratch_Exp_T = std::pmr::vector <Exp_value_T>;
+    using Scratch_NFA_T = std::pmr::vector <State_T>;
+
+
+public:
+
+    class Context;
+
+    static constexpr const std::size_t NO_LIMIT = static_cast <std::size_t>(-1);
+
+    // largest bound of a counted repetition, {m,n} with m or n past it throws
+    static constexpr const std::size_t MAX_REPEAT = 1000;
+
+    // most positions a pattern may have once its repetitions are written out
+    // (the follow sets alone take MAX_POSITIONS^2 bits), more throws
+    static constexpr const std::size_t MAX_POSITIONS = std::size_t(1) << 16;
+
+
+private:
+
+    // the bitset NFA (or its reverse) behind the same interface as Fixed_NFA
+    class Bitset_Engine
+    {
+        const Regex &m_regex;
+        Context &m_context;
+        const NFA_T &m_follow;
+
+    public:
+
+        using Set_T = State_T;
+
+        Bitset_Engine(const Regex&, Context&, const NFA_T&);
+
+        void start(Set_T&) const;
+        Set_T empty() const;
+        void clear(Set_T&) const;
+        void restart(Set_T&) const;
+
+        void step(const Set_T&, const std::size_t, Set_T&) const;
+
+        void inject(Set_T&, std::size_t*, const std::size_t) const;
+        void step(const Set_T&, const std::size_t*, const std::size_t, Set_T&, std::size_t*, std::size_t&) const;
+        static void prune(Set_T&, const std::size_t*, const std::size_t);
+
+        static bool accepting(const Set_T&);
+        static bool dead(const Set_T&);
+    };
 
 
     static constexpr const uint8_t CHAR_VAL     = 0;
@@ -46,6 +221,44 @@ class Regex
 
     static constexpr const uint8_t ESCAPE_VAL   = 7;
 
+    static constexpr const uint8_t CLASS_VAL    = 8;
+
+    static constexpr const uint8_t QUEST_VAL    = 9;
+    static constexpr const uint8_t REPEAT_VAL   = 10;
+
+
+    // a character or operator of the expression and its kind,
+    // a class (CLASS_VAL) is m_classes[index] and stands in for any of its characters,
+    // a counted repetition (REPEAT_VAL) has its bounds in m_repeats[index]
+    struct Exp_value_T
+    {
+        Char_T first;
+        uint8_t second;
+
+        std::size_t index = 0;
+    };
+
+    // sorted, disjoint and non adjacent [first, second] code unit ranges
+    using Class_T       = std::vector <std::pair <std::size_t, std::size_t>>;
+
+
+    // literals of a subexpression, see compute_literals()
+    struct Literals
+    {
+        // the language is exactly {prefix}
+        bool exact;
+
+        // every word of the language starts with prefix, ends with suffix
+        // and contains required
+        Literal_T prefix;
+        Literal_T suffix;
+        Literal_T required;
+    };
+
+
+    // byte sized characters get direct lookup tables, one entry per code unit
+    static constexpr const bool BYTE_UNITS = sizeof(Char_T) == 1;
+
 
     const std::ctype <Char_T> &facet = std::use_facet <std::ctype <Char_T>>(
         std::locale()
@@ -53,31 +266,191 @@ class Regex
     const Char_T UNION   = facet.widen('|');
     const Char_T STAR    = facet.widen('*');
     const Char_T PLUS    = facet.widen('+');
-    const Char_T CONCAT  = facet.widen('.');
+    const Char_T QUEST   = facet.widen('?');
+    const Char_T CONCAT  = facet.widen('&');    // only ever inserted by process_exp
     const Char_T OPEN    = facet.widen('(');
     const Char_T CLOSE   = facet.widen(')');
     const Char_T ESCAPE  = facet.widen('\\');
 
+    const Char_T ANY         = facet.widen('.');
+    const Char_T OPEN_CLASS  = facet.widen('[');
+    const Char_T CLOSE_CLASS = facet.widen(']');
+    const Char_T NEGATE      = facet.widen('^');
+    const Char_T RANGE       = facet.widen('-');
+    const Char_T NEWLINE     = facet.widen('\n');
+
+    const Char_T OPEN_REPEAT  = facet.widen('{');
+    const Char_T CLOSE_REPEAT = facet.widen('}');
+    const Char_T SEPARATOR    = facet.widen(',');
+
 
 private:
 
 
     NFA_T m_NFA;
 
+    // follow sets of the reversed pattern (same positions and labels),
+    // empty unless Options::reverse_search
+    NFA_T m_reverse_NFA;
+
     std::size_t m_size;
 
     Exp_T m_transition_labels;
 
+    // B[c], the states labeled with c, indexed by symbol(c)
+    NFA_T m_char_masks;
+
+    // wider characters: the sorted code units where a new run of characters
+    // labelling the same states starts
+    std::vector <std::size_t> m_alphabet;
+
+    // symbol of every code unit (byte sized characters) or run of m_alphabet:
+    // characters labelling exactly the same states are one symbol, with one
+    // mask, one lazy DFA column and one fixed NFA mask between them
+    std::vector <uint32_t> m_symbol_map;
+
+    // the character classes of the pattern, see Exp_value_T
+    std::vector <Class_T> m_classes;
+
+    // {min, max} of every counted repetition, max is NO_LIMIT for {min,}
+    std::vector <std::pair <std::size_t, std::size_t>> m_repeats;
+
+    // a counted repetition of a single position, x{m,n}, is not copied n times
+    // over but becomes a chain of n positions: copy i only moves on to copy
+    // i + 1, and every copy from the m-th on may also leave the chain, all of
+    // them to the same positions. so only the last copy keeps a follow set,
+    // the others have an empty (size 0) one and point to the last copy from
+    // here if they may leave, hold NO_LIMIT if not.
+    // empty if there are no chains, small patterns get theirs written out
+    std::vector <std::size_t> m_exits;
+
+    // the DFA built up front, empty unless Options::dfa_states allowed it
+    Eager_DFA m_DFA;
+
+    // small patterns run on plain words instead, see select_engine()
+    std::variant <std::monostate, Fixed_NFA <1>, Fixed_NFA <2>, Fixed_NFA <4>> m_fixed;
+    std::variant <std::monostate, Fixed_NFA <1>, Fixed_NFA <2>, Fixed_NFA <4>> m_fixed_reverse;
+
+    // what search looks for before starting the automaton:
+    // the literal every match starts with, the one every match contains
+    // and, per symbol, whether some match starts with it
+    Literal_T m_prefix;
+    Literal_T m_required;
+    std::vector <bool> m_starts;
+
+    // the same, scanned with memchr/SIMD, for contiguous byte input
+    Prefilter m_prefilter;
+
     const Exp_T m_postfix;
 
+    const Options m_options;
+
+    // what a context checks it was built for
+    const Identity m_identity;
+
+
+    // the rest of a blob, after the header, the options and m_postfix
+    Regex(Blob_Reader&, Exp_T&&, const Options&);
+
+    // the one doing the work, the arena lives until it is done
+    Regex(const String_T&, const Options&, Arena_T&&);
+
+    static void save_exp(Blob_Writer&, const Exp_T&);
+    static void save_sets(Blob_Writer&, const NFA_T&);
+    static void save_ranges(Blob_Writer&, const Class_T&);
+
+    // load() or view(), by whether the reader borrows
+    static Regex load(Blob_Reader&&);
+
+    static Exp_T load_exp(Blob_Reader&);
+    static NFA_T load_sets(Blob_Reader&, const std::size_t, const std::size_t);
+    static Class_T load_ranges(Blob_Reader&);
+
+    // whether the tables of a loaded Regex fit together, so nothing indexes past them
+    bool consistent() const noexcept;
+
+    Scratch_Exp_T process_exp(const String_T&, std::pmr::memory_resource&);
+
+    bool process_repeat(const String_T&, std::size_t&);
+    Scratch_Exp_T expand_repeats(const Scratch_Exp_T&) const;
 
-    Exp_T process_escape(const String_T&) const;
-    Exp_T process_concat(const Exp_T&) const;
+    Class_T process_class(const String_T&, std::size_t&) const;
 
-    Exp_T process_exp(const String_T&) const;
-    Exp_T process_postfix(const Exp_T&);
+    static Class_T negate_class(const Class_T&);
+    Exp_T process_postfix(const Scratch_Exp_T&);
 
-    void compute_NFA(const Exp_T&);
+    void compute_NFA(const Exp_T&, std::pmr::memory_resource&);
+
+    void materialize_chains();
+
+    void compute_reverse_NFA();
+    void compute_masks(std::pmr::memory_resource&);
+
+    void select_engine();
+
+    void compute_literals();
+    void compute_starts();
+
+    void compute_DFA();
+
+    // the first offset in [from, last) where a match may start, last if none;
+    // without prefix only the first symbol is looked at
+    template <typename Sample_T>
+    std::size_t skip(const Sample_T&, const std::size_t, const std::size_t, const bool = true) const;
+
+    // false if no match can start at from or later
+    template <typename Sample_T>
+    bool viable(const Sample_T&, const std::size_t) const;
+
+    std::size_t symbol(const Char_T) const noexcept;
+
+    void step(const NFA_T&, const State_T&, const std::size_t, State_T&, State_T&) const;
+
+    void prepare(Context&) const;
+
+    // the context of the overloads that dont take one: one per thread, rebuilt
+    // whenever that thread moves on to another Regex
+    static Context& local_context();
+
+    template <typename Function_T>
+    decltype(auto) with_engine(Context&, Function_T&&) const;
+
+    template <std::size_t Index>
+    const auto& fixed_reverse() const;
+
+    template <typename Engine_T, typename Function_T>
+    static decltype(auto) with_buffers(const Engine_T&, Context&, Function_T&&);
+
+    // every public match/search overload ends up in one of these,
+    // Sample_T being View_T or a Sample_Range
+    template <typename Sample_T>
+    bool match_sample(const Sample_T&, Context&) const;
+
+    template <typename Sample_T, typename Visitor_T>
+    std::size_t search_sample(const Sample_T&, Visitor_T&&, Context&) const;
+
+    template <typename Sample_T>
+    std::vector <Match> results_sample(const Sample_T&, const std::size_t, Context&) const;
+
+    template <typename Iterator_T>
+    bool run_match(const Iterator_T, const Iterator_T, Context&) const;
+
+    template <typename Engine_T, typename Iterator_T>
+    bool nfa_match(const Engine_T&, typename Engine_T::Set_T&, typename Engine_T::Set_T&, Iterator_T, const Iterator_T) const;
+
+    template <typename Iterator_T>
+    bool lazy_match(Iterator_T, const Iterator_T, Context&) const;
+
+    template <typename Iterator_T>
+    bool eager_match(Iterator_T, const Iterator_T) const;
+
+    template <typename Engine_T, typename Sample_T, typename Visitor_T>
+    std::size_t nfa_search(const Engine_T&, const Sample_T&, Context&, Visitor_T&&, const std::size_t) const;
+
+    void search_chunk(const View_T, const std::size_t, const std::size_t, Context&, std::vector <Match>&) const;
+
+    template <typename Engine_T, typename Sample_T, typename Visitor_T>
+    std::size_t reverse_search(const Engine_T&, const Engine_T&, const Sample_T&, Context&, Visitor_T&&) const;
 
     //helpers
     bool is_operator(const Char_T) const noexcept;
@@ -95,474 +468,3079 @@ private:
 
     uint8_t op_value(const Char_T) const noexcept;
 
+    static constexpr std::size_t code_unit(const Char_T) noexcept;
+
 
 public:
 
-    Regex(const String_T &);
+    // scratch space for matching: double buffered state sets, the lazy DFA
+    // cache and the search start tags, sized to the NFA once and then reused,
+    // so matching through a warmed up context never allocates.
+    // use one per thread, a context handed to another Regex is rebuilt for it
+    class Context
+    {
+        friend class Regex;
+
+        // Identity of the regex it was built for, NONE at first
+        uint64_t m_owner;
+
+        State_T m_current;
+        State_T m_next;
+
+        // step() scratch, from & B[c]
+        State_T m_active;
+
+        DFA_T m_dfa;
+
+        // search: offset each state was started from, one per position
+        std::vector <std::size_t> m_tags;
+        std::vector <std::size_t> m_next_tags;
+
+        // reverse search: match ends found by the forward scan
+        std::vector <std::size_t> m_ends;
 
+    public:
 
-    bool match(const String_T &word);
+        Context();
 
-    bool search(const String_T &sample);
+        explicit Context(const Regex &);
+    };
 
-    bool search_results(const String_T &sample, const std::size_t max_res) const;
 
+    // search over input that arrives in pieces: the state is kept between
+    // feed() calls, so matches can span them, and finish() ends the input.
+    // matches go to visitor(begin, end), as offsets from the start of the stream
+    template <typename Visitor_T>
+    class Stream;
+
+
+    Regex(const String_T &, const Options & = Options());
+
+
+    // the compiled pattern as a blob load() turns back into the same Regex,
+    // on a machine with the same byte order and for the same Char_T.
+    // Blob::MAPPED stores every set as its words, larger but viewable in full
+    std::string save(const Blob::Layout = Blob::COMPACT) const;
+
+    // a Regex from a blob of save(), without parsing or building anything:
+    // the tables are copied straight out of blob, which may be a mapped file
+    // and can go away afterwards. throws std::invalid_argument if blob is of
+    // another version, character type or byte order, or does not hold together
+    static Regex load(const std::string_view blob);
+
+    // load() without the copies: the follow sets, masks and DFA table stored
+    // as words are used where they are in blob (an 8 byte aligned one, a mapped
+    // file is), so processes mapping the same file share them. blob has to
+    // outlive the Regex and its copies; a table that is sparse or misaligned
+    // in it is still copied
+    static Regex view(const std::string_view blob);
+
+
+    // the iterator overloads take random access iterators,
+    // the offsets of their matches are relative to first
+
+    bool match(const View_T word) const;
+    bool match(const View_T word, Context &context) const;
+
+    template <typename Iterator_T>
+    bool match(const Iterator_T first, const Iterator_T last) const;
+    template <typename Iterator_T>
+    bool match(const Iterator_T first, const Iterator_T last, Context &context) const;
+
+    // whether sample contains a match, see search_results for the matches
+    bool search(const View_T sample) const;
+    bool search(const View_T sample, Context &context) const;
+
+    template <typename Iterator_T>
+    bool search(const Iterator_T first, const Iterator_T last) const;
+    template <typename Iterator_T>
+    bool search(const Iterator_T first, const Iterator_T last, Context &context) const;
+
+    // at most max_res matches, in order
+    std::vector <Match> search_results(const View_T sample, const std::size_t max_res = NO_LIMIT) const;
+    std::vector <Match> search_results(const View_T sample, const std::size_t max_res, Context &context) const;
+
+    template <typename Iterator_T>
+    std::vector <Match> search_results(const Iterator_T first, const Iterator_T last, const std::size_t max_res = NO_LIMIT) const;
+    template <typename Iterator_T>
+    std::vector <Match> search_results(
+        const Iterator_T first, const Iterator_T last, const std::size_t max_res, Context &context
+    ) const;
+
+    // writes at most max_res matches to results, returns how many
+    std::size_t search_results(const View_T sample, Match *results, const std::size_t max_res) const;
+    std::size_t search_results(const View_T sample, Match *results, const std::size_t max_res, Context &context) const;
+
+    // calls visitor(begin, end) for every match, in order, stopping early if it
+    // returns false; returns how many matches were visited
+    template <typename Visitor_T>
+    std::size_t search_each(const View_T sample, Visitor_T &&visitor) const;
+    template <typename Visitor_T>
+    std::size_t search_each(const View_T sample, Visitor_T &&visitor, Context &context) const;
+
+    template <typename Iterator_T, typename Visitor_T>
+    std::size_t search_each(const Iterator_T first, const Iterator_T last, Visitor_T &&visitor) const;
+    template <typename Iterator_T, typename Visitor_T>
+    std::size_t search_each(const Iterator_T first, const Iterator_T last, Visitor_T &&visitor, Context &context) const;
+
+    // same matches as search_results(sample), found by cutting sample into
+    // chunks searched on up to threads threads (0 for one per core)
+    std::vector <Match> parallel_search(const View_T sample, std::size_t threads = 0) const;
+
+    template <typename Visitor_T>
+    Stream <std::decay_t <Visitor_T>> stream(Visitor_T &&visitor) const;
+
+    // states of the DFA built up front, 0 if there is none, see Options::dfa_states
+    std::size_t dfa_states() const noexcept;
+
+};
+
+
+
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+class Regex <String_T, Trace_T>::Stream
+{
+    using Words_T       = std::variant <
+        std::monostate, Fixed_NFA <1>::Set_T, Fixed_NFA <2>::Set_T, Fixed_NFA <4>::Set_T
+    >;
+
+
+    static constexpr const std::size_t npos = static_cast <std::size_t>(-1);
+
+
+    const Regex &m_regex;
+
+    Visitor_T m_visitor;
+
+    // the bitset NFA keeps its state sets in here
+    Context m_context;
+
+    // the fixed width ones in here
+    Words_T m_state;
+    Words_T m_transition;
+
+    // offset of the next character to be scanned
+    std::size_t m_offset;
+
+    // best match so far, [m_begin, m_end), m_begin is npos if there is none
+    std::size_t m_begin;
+    std::size_t m_end;
+
+    // what was read past m_end, rescanned once the match is settled
+    std::vector <Char_T> m_window;
+
+    // characters to be scanned before any new input
+    std::vector <Char_T> m_replay;
+    std::size_t m_replay_pos;
+
+
+    template <typename Engine_T, typename Function_T>
+    decltype(auto) with_sets(const Engine_T&, Function_T&&);
+
+    template <typename Engine_T>
+    void scan(const Engine_T&, typename Engine_T::Set_T&, typename Engine_T::Set_T&, const Char_T*, const Char_T*);
+
+    template <typename Engine_T>
+    void settle(const Engine_T&, typename Engine_T::Set_T&);
+
+    void reset();
+
+
+public:
+
+    Stream(const Regex &, Visitor_T);
+
+
+    void feed(const Char_T *data, const std::size_t size);
+
+    // reports the match still pending, if any, and starts over at offset 0
+    void finish();
 };
 
 
 
-template <typename String_T>
-Regex <String_T>::Regex(const String_T &exp)
+// most patterns get by with the first block of the arena
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T>::Regex(const String_T &exp, const Options &options)
+    :
+    Regex(exp, options, Arena_T(std::size_t(1) << 15))
+{};
+
+
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T>::Regex(const String_T &exp, const Options &options, Arena_T &&arena)
     :
     m_postfix(
         process_postfix(
-            process_exp(exp)
+            process_exp(exp, arena)
         )
-    )
+    ),
+    m_options(options)
 {   
-    compute_NFA(m_postfix);
-    std::for_each(m_transition_labels.begin(), m_transition_labels.end(), [](auto i)->void {std::cout << i.first;});
+    compute_NFA(m_postfix, arena);
+
+    Trace_T::compiled(m_postfix, m_transition_labels);
 };
 
 
-// returns processed exp, ready for postfixing
-template <typename String_T>
-typename Regex<String_T>::Exp_T
-Regex<String_T>::process_exp(const String_T &exp) const
+// header, options and the postfix first, the constructor reads the rest
+template <typename String_T, typename Trace_T>
+std::string Regex <String_T, Trace_T>::save(const Blob::Layout layout) const
 {
+    Blob_Writer writer(layout);
 
-    // std::cout << exp;
-    // std::cout << std::endl;
+    writer.write(Blob::MAGIC);
+    writer.write(Blob::VERSION);
+    writer.write(sizeof(Char_T));
+    writer.write(sizeof(std::size_t));
 
-    Exp_T processed_exp;
-    processed_exp.reserve(exp.size() * 2 + 2);
+    writer.write(m_options.reverse_search);
+    writer.write(m_options.dfa_cache_limit);
+    writer.write(m_options.dfa_states);
+    writer.write(m_options.parallel_chunk);
 
-    processed_exp.push_back({OPEN, OPEN_VAL});
+    save_exp(writer, m_postfix);
+
+    writer.write(m_size);
+
+    save_sets(writer, m_NFA);
+    save_sets(writer, m_reverse_NFA);
 
-    std::size_t itr = 0;
-    for(itr; itr < exp.size() - 1; ++itr)
+    save_exp(writer, m_transition_labels);
+
+    save_sets(writer, m_char_masks);
+    writer.write_array(m_alphabet.data(), m_alphabet.size());
+    writer.write_array(m_symbol_map.data(), m_symbol_map.size());
+
+    writer.write(m_classes.size());
+    for(const Class_T &ranges : m_classes)
     {
-        // escape characters
-        const Exp_value_T curr_ch = (exp[itr] == ESCAPE)
-            ? Exp_value_T{exp[++itr], CHAR_VAL}
-            : Exp_value_T{exp[itr], op_value(exp[itr])};
-
-        // Exp_value_T curr_ch;
-        // if(exp[itr] == ESCAPE)
-        // {
-        //     ++itr;
-        //     curr_ch = Exp_value_T{exp[itr], CHAR_VA L}
-        // }
-        // else
-        // {
-        //     curr_ch = Exp_value_T{exp[itr], op_value(exp[itr])}
-        // }
+        save_ranges(writer, ranges);
+    }
+    save_ranges(writer, m_repeats);
 
-        // add concat operators
-        if(detect_concat(processed_exp.back(), curr_ch))
-        {
-            processed_exp.push_back({CONCAT, CONCAT_VAL});
-        }
+    writer.write_array(m_exits.data(), m_exits.size());
 
-        processed_exp.push_back(curr_ch);
+    m_DFA.save(writer);
+
+    writer.write_array(m_prefix.data(), m_prefix.size());
+    writer.write_array(m_required.data(), m_required.size());
+
+    return writer.release();
+};
+
+
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T> Regex <String_T, Trace_T>::load(const std::string_view blob)
+{
+    return load(Blob_Reader(blob.data(), blob.size()));
+};
+
+
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T> Regex <String_T, Trace_T>::view(const std::string_view blob)
+{
+    return load(Blob_Reader(blob.data(), blob.size(), true));
+};
+
+
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T> Regex <String_T, Trace_T>::load(Blob_Reader &&reader)
+{
+    if(reader.read() != Blob::MAGIC || reader.read() != Blob::VERSION
+        || reader.read() != sizeof(Char_T) || reader.read() != sizeof(std::size_t))
+    {
+        throw std::invalid_argument("regex blob of another version, character type or byte order");
     }
 
-    if(itr < exp.size())
+    Options options;
+    options.reverse_search = reader.read() != 0;
+    options.dfa_cache_limit = reader.read_size();
+    options.dfa_states = reader.read_size();
+    options.parallel_chunk = reader.read_size();
+
+    Exp_T postfix = load_exp(reader);
+
+    return Regex(reader, std::move(postfix), options);
+};
+
+
+// what compute_NFA would have built is read instead, only the fixed width
+// engines and the prefilter are derived again
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T>::Regex(Blob_Reader &reader, Exp_T &&postfix, const Options &options)
+    :
+    m_postfix(std::move(postfix)),
+    m_options(options)
+{
+    // every position takes more than a byte of the blob
+    m_size = reader.read_size();
+    if(m_size >= reader.remaining())
     {
-        // add concat operators
-        if(detect_concat(processed_exp.back().first, exp[itr]))
-        {
-            processed_exp.push_back({CONCAT, CONCAT_VAL});
-        }
+        Blob_Reader::malformed();
+    }
+
+    m_NFA = load_sets(reader, m_size + 1, m_size + 1);
+    m_reverse_NFA = load_sets(reader, m_size + 1, m_size + 1);
+
+    m_transition_labels = load_exp(reader);
+
+    m_char_masks = load_sets(reader, reader.remaining(), m_size + 1);
+    reader.read_array(m_alphabet);
+    reader.read_array(m_symbol_map);
 
-        processed_exp.push_back({exp[itr], op_value(exp[itr])});
+    for(std::size_t count = reader.read_size(); count; --count)
+    {
+        m_classes.push_back(load_ranges(reader));
     }
+    m_repeats = load_ranges(reader);
 
-    processed_exp.push_back({CLOSE, CLOSE_VAL});
+    reader.read_array(m_exits);
+
+    m_DFA.load(reader);
+
+    reader.read_array(m_prefix);
+    reader.read_array(m_required);
+
+    if(!reader.done() || !consistent())
+    {
+        Blob_Reader::malformed();
+    }
+
+    select_engine();
+    compute_starts();
+};
+
+
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::save_exp(Blob_Writer &writer, const Exp_T &exp)
+{
+    writer.write(exp.size());
+    for(const Exp_value_T &chr : exp)
+    {
+        writer.write(code_unit(chr.first));
+        writer.write(chr.second);
+        writer.write(chr.index);
+    }
+};
+
+
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::save_sets(Blob_Writer &writer, const NFA_T &sets)
+{
+    writer.write(sets.size());
+    for(const State_T &set : sets)
+    {
+        writer.write(set);
+    }
+};
+
+
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::save_ranges(Blob_Writer &writer, const Class_T &ranges)
+{
+    writer.write(ranges.size());
+    for(const auto &range : ranges)
+    {
+        writer.write(range.first);
+        writer.write(range.second);
+    }
+};
+
+
+// the counts are not trusted with a reserve(), a cut blob throws first
+template <typename String_T, typename Trace_T>
+typename Regex <String_T, Trace_T>::Exp_T
+Regex <String_T, Trace_T>::load_exp(Blob_Reader &reader)
+{
+    Exp_T exp;
+    for(std::size_t count = reader.read_size(); count; --count)
+    {
+        const auto first = static_cast <Char_T>(reader.read());
+        const auto second = static_cast <uint8_t>(reader.read());
+
+        exp.push_back({first, second, reader.read_size()});
+    }
+
+    return exp;
+};
+
+
+template <typename String_T, typename Trace_T>
+typename Regex <String_T, Trace_T>::NFA_T
+Regex <String_T, Trace_T>::load_sets(Blob_Reader &reader, const std::size_t max_count, const std::size_t max_size)
+{
+    std::size_t count = reader.read_size();
+    if(count > max_count)
+    {
+        Blob_Reader::malformed();
+    }
+
+    NFA_T sets;
+    for(; count; --count)
+    {
+        sets.emplace_back();
+        reader.read(sets.back(), max_size);
+    }
+
+    return sets;
+};
+
+
+template <typename String_T, typename Trace_T>
+typename Regex <String_T, Trace_T>::Class_T
+Regex <String_T, Trace_T>::load_ranges(Blob_Reader &reader)
+{
+    Class_T ranges;
+    for(std::size_t count = reader.read_size(); count; --count)
+    {
+        const std::size_t first = reader.read_size();
+
+        ranges.push_back({first, reader.read_size()});
+    }
+
+    return ranges;
+};
+
+
+// the sizes step() and the engines rely on, not whether the automaton is
+// the one of the pattern
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::consistent() const noexcept
+{
+    if(m_NFA.empty() || m_NFA.size() - 1 != m_size || m_NFA[0].size() != m_size + 1
+        || m_transition_labels.size() != m_NFA.size() || m_char_masks.empty())
+    {
+        return false;
+    }
+
+    if(!m_exits.empty() && m_exits.size() != m_NFA.size())
+    {
+        return false;
+    }
+
+    // only the copies of a chain have empty follow sets, and they are followed
+    // by the next copy
+    for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
+    {
+        if(m_NFA[itr].size() == m_size + 1)
+        {
+            continue;
+        }
+
+        if(m_NFA[itr].size() != 0 || m_exits.empty() || itr == m_size)
+        {
+            return false;
+        }
+    }
+
+    for(const std::size_t exit : m_exits)
+    {
+        if(exit != NO_LIMIT && (exit > m_size || m_NFA[exit].size() != m_size + 1))
+        {
+            return false;
+        }
+    }
+
+    // only built without chains
+    if(!m_reverse_NFA.empty() && (m_reverse_NFA.size() != m_NFA.size() || !m_exits.empty()))
+    {
+        return false;
+    }
+
+    for(const NFA_T *sets : {&m_reverse_NFA, &m_char_masks})
+    {
+        for(const State_T &set : *sets)
+        {
+            if(set.size() != m_size + 1)
+            {
+                return false;
+            }
+        }
+    }
+
+    // the reverse has to be the one compute_reverse_NFA builds: reverse_search
+    // only moves on if the forward walk finds an end for the start it found.
+    // it is the transpose, every edge is looked up both ways
+    if(!m_reverse_NFA.empty())
+    {
+        for(const NFA_T *sets : {&m_NFA, &m_reverse_NFA})
+        {
+            const NFA_T &other = sets == &m_NFA ? m_reverse_NFA : m_NFA;
+
+            for(std::size_t itr = 0; itr < sets->size(); ++itr)
+            {
+                const State_T &set = (*sets)[itr];
+                for(const std::size_t jtr : set.ones())
+                {
+                    if(!other[jtr].test(itr))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    const std::size_t units = BYTE_UNITS ? std::size_t(1) << CHAR_BIT : m_alphabet.size() + 1;
+    if(m_symbol_map.size() != units)
+    {
+        return false;
+    }
+
+    for(const uint32_t symbol : m_symbol_map)
+    {
+        if(symbol >= m_char_masks.size())
+        {
+            return false;
+        }
+    }
+
+    return m_DFA.empty() || m_DFA.columns() == m_char_masks.size();
+};
+
+
+// returns processed exp, ready for postfixing
+template <typename String_T, typename Trace_T>
+typename Regex<String_T, Trace_T>::Scratch_Exp_T
+Regex<String_T, Trace_T>::process_exp(const String_T &exp, std::pmr::memory_resource &arena)
+{
+    Scratch_Exp_T processed_exp(&arena);
+    processed_exp.reserve(exp.size() * 2 + 2);
+
+    processed_exp.push_back({OPEN, OPEN_VAL});
+
+    for(std::size_t itr = 0; itr < exp.size(); ++itr)
+    {
+        Exp_value_T curr_ch{exp[itr], op_value(exp[itr])};
+
+        // escape characters
+        if(exp[itr] == ESCAPE)
+        {
+            if(itr + 1 == exp.size())
+            {
+                throw std::invalid_argument("rgx: escape at the end of the pattern");
+            }
+
+            curr_ch = {exp[++itr], CHAR_VAL};
+        }
+        else if(exp[itr] == OPEN_CLASS)
+        {
+            curr_ch = {OPEN_CLASS, CLASS_VAL, m_classes.size()};
+            m_classes.push_back(process_class(exp, itr));
+        }
+        else if(exp[itr] == ANY)
+        {
+            curr_ch = {ANY, CLASS_VAL, m_classes.size()};
+            m_classes.push_back(negate_class({{code_unit(NEWLINE), code_unit(NEWLINE)}}));
+        }
+        else if(exp[itr] == OPEN_REPEAT && process_repeat(exp, itr))
+        {
+            curr_ch = {OPEN_REPEAT, REPEAT_VAL, m_repeats.size() - 1};
+        }
+
+        // add concat operators
+        if(detect_concat(processed_exp.back(), curr_ch))
+        {
+            processed_exp.push_back({CONCAT, CONCAT_VAL});
+        }
+
+        processed_exp.push_back(curr_ch);
+    }
+
+    processed_exp.push_back({CLOSE, CLOSE_VAL});
+
+    return processed_exp;
+};
+
+
+// reads the class opened at exp[itr], leaving itr on its closing bracket.
+// a ] or - right after the opening bracket (or ^) and a - right before the
+// closing one are taken literally, \ escapes anything
+template <typename String_T, typename Trace_T>
+typename Regex<String_T, Trace_T>::Class_T
+Regex<String_T, Trace_T>::process_class(const String_T &exp, std::size_t &itr) const
+{
+    const auto unit = [&]()
+    {
+        if(exp[itr] == ESCAPE && itr + 1 < exp.size())
+        {
+            ++itr;
+        }
+
+        return code_unit(exp[itr++]);
+    };
+
+    Class_T ranges;
+
+    ++itr;
+
+    const bool negated = itr < exp.size() && exp[itr] == NEGATE;
+    if(negated)
+    {
+        ++itr;
+    }
+
+    for(bool first = true; itr < exp.size() && (first || exp[itr] != CLOSE_CLASS); first = false)
+    {
+        const std::size_t low = unit();
+        std::size_t high = low;
+
+        if(itr + 1 < exp.size() && exp[itr] == RANGE && exp[itr + 1] != CLOSE_CLASS)
+        {
+            ++itr;
+            high = unit();
+
+            if(high < low)
+            {
+                throw std::invalid_argument("rgx: reversed range in character class");
+            }
+        }
+
+        ranges.push_back({low, high});
+    }
+
+    if(itr >= exp.size())
+    {
+        throw std::invalid_argument("rgx: unterminated character class");
+    }
+
+    // merge what overlaps or touches
+    std::sort(ranges.begin(), ranges.end());
+
+    Class_T merged;
+    for(const auto &range : ranges)
+    {
+        if(!merged.empty() && range.first <= merged.back().second + 1)
+        {
+            merged.back().second = std::max(merged.back().second, range.second);
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+
+    return negated
+        ? negate_class(merged)
+        : merged;
+};
+
+
+// reads {m}, {m,} or {m,n} at exp[itr] into m_repeats, leaving itr on the
+// closing brace; anything else is no repetition and the brace a literal
+template <typename String_T, typename Trace_T>
+bool Regex<String_T, Trace_T>::process_repeat(const String_T &exp, std::size_t &itr)
+{
+    std::size_t pos = itr + 1;
+
+    const auto number = [&](std::size_t &value)
+    {
+        const std::size_t first = pos;
+
+        // kept from overflowing, anything past MAX_REPEAT is refused anyway
+        for(value = 0; pos < exp.size() && facet.is(std::ctype_base::digit, exp[pos]); ++pos)
+        {
+            value = std::min(value * 10 + (facet.narrow(exp[pos], '0') - '0'), MAX_REPEAT + 1);
+        }
+
+        return pos != first;
+    };
+
+    std::size_t min = 0;
+    std::size_t max = 0;
+
+    if(!number(min))
+    {
+        return false;
+    }
+
+    if(pos < exp.size() && exp[pos] == SEPARATOR)
+    {
+        ++pos;
+
+        if(!number(max))
+        {
+            max = NO_LIMIT;
+        }
+    }
+    else
+    {
+        max = min;
+    }
+
+    if(pos >= exp.size() || exp[pos] != CLOSE_REPEAT)
+    {
+        return false;
+    }
+
+    if(max < min)
+    {
+        throw std::invalid_argument("rgx: repetition bounds out of order");
+    }
+
+    if(min > MAX_REPEAT || (max != NO_LIMIT && max > MAX_REPEAT))
+    {
+        throw std::invalid_argument("rgx: repetition bound too large");
+    }
+
+    m_repeats.push_back({min, max});
+    itr = pos;
+
+    return true;
+};
+
+
+// every code unit not in ranges
+template <typename String_T, typename Trace_T>
+typename Regex<String_T, Trace_T>::Class_T
+Regex<String_T, Trace_T>::negate_class(const Class_T &ranges)
+{
+    constexpr std::size_t max_unit = std::numeric_limits <std::make_unsigned_t <Char_T>>::max();
+
+    Class_T negated;
+
+    std::size_t low = 0;
+    for(const auto &range : ranges)
+    {
+        if(range.first > low)
+        {
+            negated.push_back({low, range.first - 1});
+        }
+
+        low = range.second + 1;
+    }
+
+    if(low <= max_unit)
+    {
+        negated.push_back({low, max_unit});
+    }
+
+    return negated;
+};
+
+
+// calculates nr of states.
+// throws std::invalid_argument for an empty pattern or group, unbalanced
+// parentheses and an operator missing an operand (a||, *a)
+template <typename String_T, typename Trace_T>
+typename Regex<String_T, Trace_T>::Exp_T
+Regex <String_T, Trace_T>::process_postfix(const Scratch_Exp_T &exp)
+{
+    m_size = 0;
+
+    // std::for_each(exp.begin(), exp.end(), [](auto i)->void {std::cout << i.first;});
+    // std::for_each(exp.begin(), exp.end(), [](auto i)->void {std::cout << (unsigned int)i.second << ' ';});
+    // std::cout << std::endl;
+
+    Scratch_Exp_T processed_exp(exp.get_allocator());
+    processed_exp.reserve(exp.size());
+
+    std::stack <Exp_value_T, Scratch_Exp_T> conversion_stack(Scratch_Exp_T(exp.get_allocator()));
+
+    // the whole pattern is wrapped in a group by process_exp, a ) of the
+    // pattern closing that one leaves the stack empty
+    const auto unbalanced = []()
+    {
+        throw std::invalid_argument("rgx: unbalanced parentheses");
+    };
+
+    for(std::size_t itr = 0; itr < exp.size(); ++itr)
+    {
+        const Exp_value_T &chr = exp[itr];
+
+        if(is_character(chr))
+        {
+            processed_exp.push_back(chr);
+
+            continue;
+        }
+
+        if(chr.second == OPEN_VAL)
+        {
+            conversion_stack.push(chr);
+
+            continue;
+        }
+
+        if(conversion_stack.empty())
+        {
+            unbalanced();
+        }
+
+        if(is_operator(chr))
+        {
+            while(!conversion_stack.empty() && operator_precedence(conversion_stack.top()) >= operator_precedence(chr))
+            {
+                processed_exp.push_back(conversion_stack.top());
+                conversion_stack.pop();
+            }
+
+            conversion_stack.push(chr);
+
+            continue;
+        }
+
+        // the first ( and the last ) are the ones of process_exp
+        if(exp[itr - 1].second == OPEN_VAL)
+        {
+            const bool outer_open = itr == 1;
+            const bool outer_close = itr + 1 == exp.size();
+
+            if(outer_open != outer_close)
+            {
+                unbalanced();
+            }
+
+            throw std::invalid_argument(outer_open ? "rgx: empty pattern" : "rgx: empty group");
+        }
+
+        while(!conversion_stack.empty() && conversion_stack.top().second != OPEN_VAL)
+        {
+            processed_exp.push_back(conversion_stack.top());
+            conversion_stack.pop();
+        }
+
+        if(conversion_stack.empty())
+        {
+            unbalanced();
+        }
+
+        conversion_stack.pop();
+    }
+
+    if(!conversion_stack.empty())
+    {
+        unbalanced();
+    }
+
+    // every operator has its operands and a single expression is left
+    std::size_t operands = 0;
+    for(const Exp_value_T &chr : processed_exp)
+    {
+        const std::size_t needed = chr.second == UNION_VAL || chr.second == CONCAT_VAL ? 2 : 1;
+
+        if(is_character(chr))
+        {
+            ++operands;
+        }
+        else if(operands < needed)
+        {
+            throw std::invalid_argument("rgx: operator without an operand");
+        }
+        else
+        {
+            operands -= needed - 1;
+        }
+    }
+
+    if(operands != 1)
+    {
+        throw std::invalid_argument("rgx: operator without an operand");
+    }
+
+    processed_exp = expand_repeats(processed_exp);
+
+    for(const Exp_value_T chr : processed_exp)
+    {
+        if(is_character(chr))
+        {
+            ++m_size;    // increment number of states
+        }
+
+        // the other copies of a chain
+        if(chr.second == REPEAT_VAL)
+        {
+            const auto &repeat = m_repeats[chr.index];
+
+            m_size += (repeat.second == NO_LIMIT ? std::max(repeat.first, std::size_t(1)) : repeat.second) - 1;
+        }
+    }
+
+    if(m_size > MAX_POSITIONS)
+    {
+        throw std::invalid_argument("rgx: pattern too large");
+    }
+
+    // the only copy that outlives the arena, sized to fit
+    return Exp_T(processed_exp.begin(), processed_exp.end());
+};
+
+
+// rewrites every counted repetition of more than a single position in terms
+// of the other operators, x{m,n} being m copies of x followed by n - m nested
+// optional ones, (x(x(x)?)?)?, and x{m,} m - 1 copies followed by x+.
+// the ones of a single position are left to compute_NFA, see m_exits.
+// x{0} is the empty word: x is dropped and so is the operator applied to
+// it, F | x{0} becomes F?; a pattern that is nothing but the empty word
+// comes back empty
+template <typename String_T, typename Trace_T>
+typename Regex<String_T, Trace_T>::Scratch_Exp_T
+Regex <String_T, Trace_T>::expand_repeats(const Scratch_Exp_T &exp) const
+{
+    Scratch_Exp_T expanded(exp.get_allocator());
+    expanded.reserve(exp.size());
+
+    // where the postfix of every operand on the stack starts
+    std::stack <std::size_t, std::pmr::vector <std::size_t>> operands(std::pmr::vector <std::size_t>(exp.get_allocator()));
+
+    // positions in expanded so far, checked before every copy is written
+    // out so nested repetitions cannot blow up before m_size is known
+    std::size_t positions = 0;
+
+    // the start of an operand x{0} left without positions
+    constexpr std::size_t EPSILON = NO_LIMIT;
+
+    const auto count_positions = [](const auto first, const auto last) -> std::size_t
+    {
+        return std::count_if(first, last, [](const Exp_value_T &value)
+        {
+            return is_character(value);
+        });
+    };
+
+    for(const Exp_value_T &chr : exp)
+    {
+        if(is_character(chr))
+        {
+            operands.push(expanded.size());
+            ++positions;
+        }
+        else if(chr.second == UNION_VAL || chr.second == CONCAT_VAL)
+        {
+            const std::size_t right = operands.top();
+            operands.pop();
+
+            if(operands.top() == EPSILON || right == EPSILON)
+            {
+                // the other operand is the last one written, if any
+                if(operands.top() == EPSILON)
+                {
+                    operands.top() = right;
+                }
+
+                if(chr.second == UNION_VAL && operands.top() != EPSILON)
+                {
+                    expanded.push_back({QUEST, QUEST_VAL});
+                }
+
+                continue;
+            }
+        }
+        else if(operands.top() == EPSILON)
+        {
+            // E*, E+, E? and E{m,n} of the empty word are the empty word
+            continue;
+        }
+        else if(chr.second == REPEAT_VAL && m_repeats[chr.index].second == 0)
+        {
+            positions -= count_positions(expanded.begin() + operands.top(), expanded.end());
+
+            expanded.resize(operands.top());
+            operands.top() = EPSILON;
+
+            continue;
+        }
+        else if(chr.second == REPEAT_VAL && expanded.size() - operands.top() > 1)
+        {
+            const Scratch_Exp_T operand(expanded.begin() + operands.top(), expanded.end(), expanded.get_allocator());
+            expanded.resize(operands.top());
+
+            const std::size_t min = m_repeats[chr.index].first;
+            const std::size_t max = m_repeats[chr.index].second;
+
+            const std::size_t operand_positions = count_positions(operand.begin(), operand.end());
+            const std::size_t copies = max == NO_LIMIT ? std::max(min, std::size_t(1)) : max;
+
+            // both at most MAX_POSITIONS, the product does not overflow
+            positions -= operand_positions;
+            if(operand_positions * copies > MAX_POSITIONS - std::min(positions, MAX_POSITIONS))
+            {
+                throw std::invalid_argument("rgx: pattern too large");
+            }
+            positions += operand_positions * copies;
+
+            // part, then part CONCAT for every following one
+            bool first = true;
+            const auto append = [&](const std::initializer_list <Exp_value_T> tail)
+            {
+                expanded.insert(expanded.end(), operand.begin(), operand.end());
+                expanded.insert(expanded.end(), tail);
+
+                if(!first)
+                {
+                    expanded.push_back({CONCAT, CONCAT_VAL});
+                }
+                first = false;
+            };
+
+            if(max == NO_LIMIT)
+            {
+                for(std::size_t copy = 1; copy < min; ++copy)
+                {
+                    append({});
+                }
+
+                append({{min ? PLUS : STAR, min ? PLUS_VAL : STAR_VAL}});
+
+                continue;
+            }
+
+            for(std::size_t copy = 0; copy < min; ++copy)
+            {
+                append({});
+            }
+
+            if(max > min)
+            {
+                // (x(x(x)?)?)? is x x x ? . ? . ? in postfix
+                for(std::size_t copy = min; copy < max; ++copy)
+                {
+                    expanded.insert(expanded.end(), operand.begin(), operand.end());
+                }
+
+                expanded.push_back({QUEST, QUEST_VAL});
+
+                for(std::size_t copy = min + 1; copy < max; ++copy)
+                {
+                    expanded.push_back({CONCAT, CONCAT_VAL});
+                    expanded.push_back({QUEST, QUEST_VAL});
+                }
+
+                if(!first)
+                {
+                    expanded.push_back({CONCAT, CONCAT_VAL});
+                }
+            }
+
+            continue;
+        }
+
+        expanded.push_back(chr);
+    }
+
+    return expanded;
+};
+
+
+
+
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::compute_NFA(const Exp_T &exp, std::pmr::memory_resource &arena)
+{
+    m_NFA.reserve(m_size + 1);
+    m_transition_labels.reserve(m_size + 1);
+
+    // the follow sets are built in place, m_NFA is one block from the start
+    std::stack <State_T, Scratch_NFA_T> first_stack {Scratch_NFA_T(&arena)};
+    std::stack <State_T, Scratch_NFA_T> last_stack {Scratch_NFA_T(&arena)};
+
+    // Follow(p) |= first for every p in last, going only over the set bits of
+    // last (a Last set never holds positions from outside its subexpression);
+    // the copies of a chain leave through its last one
+    const auto follow = [this](const State_T &last, const State_T &first)
+    {
+        for(const std::size_t pos : last.ones(1))
+        {
+            if(m_NFA[pos].size())
+            {
+                m_NFA[pos] |= first;
+            }
+        }
+    };
+
+    m_NFA.push_back(State_T(m_size + 1));    //first
+    m_transition_labels.push_back({'/', 0});
+
+    std::size_t itr = 1;
+    for(const Exp_value_T &chr : exp)
+    {
+        if(is_character(chr))
+        {
+            // each character has a state 
+            m_transition_labels.push_back(chr);
+
+            State_T mask(m_size + 1);
+            mask.set(itr);
+
+            // First(x) = {x}
+            first_stack.push(mask);
+            // Last(x) = {x}
+            last_stack.push(std::move(mask));
+
+            // we push the empty bit to its follow() since they come in order
+            m_NFA.push_back(State_T(m_size + 1));
+
+            itr++;
+        }
+        else
+        {
+            if(chr.second == STAR_VAL)
+            {
+                // we keep track whether epsilon belongs to the current 
+                // subsequence of RE using the 0th byte
+
+                // First(E*) = First(E+) = First(E)
+                first_stack.top().set(0);
+
+                // Last(E*) = Last(E+) = Last(E)
+                last_stack.top().set(0);
+
+                // follow
+                follow(last_stack.top(), first_stack.top());
+            }
+            if(chr.second == PLUS_VAL)
+            {
+                // First, Last and nullability of E+ are those of E,
+                // follow as for E*
+                follow(last_stack.top(), first_stack.top());
+            }
+            if(chr.second == QUEST_VAL)
+            {
+                // E? = E | epsilon, only nullable
+                first_stack.top().set(0);
+                last_stack.top().set(0);
+            }
+            if(chr.second == REPEAT_VAL)
+            {
+                // x{m,n} of the position x just pushed, see m_exits
+                const std::size_t min = m_repeats[chr.index].first;
+                const std::size_t max = m_repeats[chr.index].second;
+
+                const std::size_t copies = max == NO_LIMIT ? std::max(min, std::size_t(1)) : max;
+                const std::size_t first = itr - 1;
+                const std::size_t last = first + copies - 1;
+
+                // copies before the m-th cant leave, nor can the first of x{0,n}
+                const std::size_t exits = first + std::max(min, std::size_t(1)) - 1;
+
+                if(copies > 1 && m_exits.empty())
+                {
+                    m_exits.assign(m_size + 1, NO_LIMIT);
+                }
+
+                m_NFA.back() = State_T();
+                for(std::size_t copy = first; copy < last; ++copy)
+                {
+                    m_exits[copy] = copy >= exits ? last : NO_LIMIT;
+
+                    m_transition_labels.push_back(m_transition_labels.back());
+                    m_NFA.push_back(State_T());
+                }
+                m_NFA.back() = State_T(m_size + 1);
+
+                // x{m,} stays in its last copy
+                if(max == NO_LIMIT)
+                {
+                    m_NFA.back().set(last);
+                }
+
+                first_stack.top().set(0, min == 0);
+
+                last_stack.top().reset(first);
+                for(std::size_t copy = exits; copy <= last; ++copy)
+                {
+                    last_stack.top().set(copy);
+                }
+                last_stack.top().set(0, min == 0);
+
+                itr = last + 1;
+            }
+            if(chr.second == UNION_VAL)
+            {
+                // First(F | G) = First(F) U First(G)
+                State_T mask = std::move(first_stack.top());
+                first_stack.pop();
+                first_stack.top() |= mask;
+
+                // Last(F | G) = Last(F) U Last(G)
+                mask = std::move(last_stack.top());
+                last_stack.pop();
+                last_stack.top() |= mask;
+
+                // nothing changes for follow
+            }
+            if(chr.second == CONCAT_VAL)
+            {
+                State_T firstG = std::move(first_stack.top());
+                first_stack.pop();
+
+                State_T lastG = std::move(last_stack.top());
+                last_stack.pop();
+
+                // follow, while the top of the stacks is still F:
+                // Follow(p) |= First(G) for every p in Last(F)
+                follow(last_stack.top(), firstG);
+
+
+                // First(F + G) = First(F) if epsilon DOES NOT belong to L(F);
+                // First(F + G) = First(F) U First(G) if epsilon belongs to L(F)
+
+                if(first_stack.top().test(0))
+                {
+                    if(!firstG.test(0))
+                    {
+                        first_stack.top().reset(0);
+                    }
+
+                    first_stack.top() |= firstG;
+                }
+
+
+                // Last(F + G) = Last(G) if epsilon DOES NOT belong to L(G);
+                // Last(F + G) = Last(F) U Last(G) if epsilon belongs to L(G)
+
+                if(lastG.test(0))
+                {
+                    if(!last_stack.top().test(0))
+                    {
+                        lastG.reset(0);
+                    }
+
+                    last_stack.top() |= lastG;
+                }
+                else
+                {
+                    last_stack.top() = std::move(lastG);
+                }
+            }
+        }
+    }
+
+    // a pattern of the empty word only, see expand_repeats
+    if(first_stack.empty())
+    {
+        m_NFA[0].set(0);
+    }
+    else
+    {
+        m_NFA[0] = std::move(first_stack.top());
+    }
+
+    for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
+    {
+        if(m_NFA[itr].size())
+        {
+            m_NFA[itr].set(0, last_stack.top().test(itr));
+        }
+    }
+
+    // chains only pay off on the bitset NFA
+    if(!m_exits.empty() && m_size + 1 <= Fixed_NFA <4>::CAPACITY)
+    {
+        materialize_chains();
+    }
+
+    // the reverse of a chain is no chain, those patterns search with tags
+    if(m_options.reverse_search && m_exits.empty())
+    {
+        compute_reverse_NFA();
+    }
+
+    compute_masks(arena);
+
+    select_engine();
+
+    compute_literals();
+    compute_starts();
+
+    compute_DFA();
+};
+
+
+// gives every copy of a chain its own follow set
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::materialize_chains()
+{
+    for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
+    {
+        if(m_NFA[itr].size())
+        {
+            continue;
+        }
+
+        State_T follow(m_size + 1);
+        follow.set(itr + 1);
+
+        if(m_exits[itr] != NO_LIMIT)
+        {
+            follow |= m_NFA[m_exits[itr]];
+        }
+
+        m_NFA[itr] = std::move(follow);
+    }
+
+    m_exits.clear();
+};
+
+
+// swaps First/Last and inverts the follow relation:
+// p follows q in the reverse iff q follows p in the original
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::compute_reverse_NFA()
+{
+    m_reverse_NFA.assign(m_NFA.size(), State_T(m_size + 1));
+
+    // First(reverse) = Last, nullable either way
+    m_reverse_NFA[0].set(0, m_NFA[0].test(0));
+
+    for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
+    {
+        const State_T &follow = m_NFA[itr];
+
+        for(const std::size_t jtr : follow.ones())
+        {
+            m_reverse_NFA[jtr].set(itr);
+        }
+    }
+
+    // Last(reverse) = First
+    for(const std::size_t itr : m_NFA[0].ones(1))
+    {
+        m_reverse_NFA[itr].set(0);
+    }
+};
+
+
+// patterns with at most 255 positions keep every state set in 1, 2 or 4 words
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::select_engine()
+{
+    const auto emplace = [&](auto index)
+    {
+        m_fixed.template emplace <index()>(m_NFA, m_char_masks);
+
+        if(!m_reverse_NFA.empty())
+        {
+            m_fixed_reverse.template emplace <index()>(m_reverse_NFA, m_char_masks);
+        }
+    };
+
+    if(m_size + 1 <= Fixed_NFA <1>::CAPACITY)
+    {
+        emplace(std::integral_constant <std::size_t, 1>());
+    }
+    else if(m_size + 1 <= Fixed_NFA <2>::CAPACITY)
+    {
+        emplace(std::integral_constant <std::size_t, 2>());
+    }
+    else if(m_size + 1 <= Fixed_NFA <4>::CAPACITY)
+    {
+        emplace(std::integral_constant <std::size_t, 3>());
+    }
+};
+
+
+// a position is set in the mask of every character its label (a literal or a class) takes
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::compute_masks(std::pmr::memory_resource &arena)
+{
+    // the ranges of code units the label of position itr takes, as visit(low, high)
+    const auto for_ranges = [this](const std::size_t itr, const auto &visit)
+    {
+        const Exp_value_T &label = m_transition_labels[itr];
+
+        if(label.second == CLASS_VAL)
+        {
+            for(const auto &range : m_classes[label.index])
+            {
+                visit(range.first, range.second);
+            }
+        }
+        else
+        {
+            visit(code_unit(label.first), code_unit(label.first));
+        }
+    };
+
+    // one per code unit or run, before the equal ones are merged
+    Scratch_NFA_T char_masks(&arena);
+
+    if constexpr (BYTE_UNITS)
+    {
+        char_masks.assign(std::size_t(1) << CHAR_BIT, State_T(m_size + 1));
+
+        for(std::size_t itr = 1; itr < m_transition_labels.size(); ++itr)
+        {
+            for_ranges(itr, [&](const std::size_t low, const std::size_t high)
+            {
+                for(std::size_t unit = low; unit <= high; ++unit)
+                {
+                    char_masks[unit].set(itr);
+                }
+            });
+        }
+    }
+    else
+    {
+        // every range starts a run and ends one
+        m_alphabet.clear();
+        for(std::size_t itr = 1; itr < m_transition_labels.size(); ++itr)
+        {
+            for_ranges(itr, [&](const std::size_t low, const std::size_t high)
+            {
+                m_alphabet.push_back(low);
+                m_alphabet.push_back(high + 1);
+            });
+        }
+
+        std::sort(m_alphabet.begin(), m_alphabet.end());
+        m_alphabet.erase(std::unique(m_alphabet.begin(), m_alphabet.end()), m_alphabet.end());
+
+        char_masks.assign(m_alphabet.size() + 1, State_T(m_size + 1));
+
+        for(std::size_t itr = 1; itr < m_transition_labels.size(); ++itr)
+        {
+            for_ranges(itr, [&](const std::size_t low, const std::size_t high)
+            {
+                const std::size_t first = std::upper_bound(m_alphabet.begin(), m_alphabet.end(), low) - m_alphabet.begin();
+                const std::size_t last = std::upper_bound(m_alphabet.begin(), m_alphabet.end(), high) - m_alphabet.begin();
+
+                for(std::size_t symbol = first; symbol <= last; ++symbol)
+                {
+                    char_masks[symbol].set(itr);
+                }
+            });
+        }
+    }
+
+    // one mask per distinct one, in order of first appearance; the table
+    // holds the index of the first of every kind, and they are only moved
+    // out once every other was compared against them
+    const auto hash = [&char_masks](const std::size_t itr)
+    {
+        return char_masks[itr].hash();
+    };
+
+    const auto equal = [&char_masks](const std::size_t lhs, const std::size_t rhs)
+    {
+        return char_masks[lhs] == char_masks[rhs];
+    };
+
+    std::pmr::unordered_map <std::size_t, uint32_t, decltype(hash), decltype(equal)> symbols(char_masks.size(), hash, equal, &arena);
+
+    std::pmr::vector <std::size_t> kinds(&arena);
+
+    m_symbol_map.resize(char_masks.size());
+
+    for(std::size_t itr = 0; itr < char_masks.size(); ++itr)
+    {
+        const auto found = symbols.try_emplace(itr, static_cast <uint32_t>(kinds.size()));
+        if(found.second)
+        {
+            kinds.push_back(itr);
+        }
+
+        m_symbol_map[itr] = found.first->second;
+    }
+
+    NFA_T masks;
+    masks.reserve(kinds.size());
+
+    for(const std::size_t kind : kinds)
+    {
+        masks.push_back(std::move(char_masks[kind]));
+    }
+
+    m_char_masks = std::move(masks);
+};
+
+
+// the literals every match starts with and contains, found by a walk over the
+// postfix expression much like the one of compute_NFA, but on strings:
+// a character is exactly itself, concatenation joins the suffix of F to the
+// prefix of G, union keeps what both sides have in common and star keeps nothing
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::compute_literals()
+{
+    // longer literals dont make the scans any faster
+    constexpr std::size_t max_size = 64;
+
+    const auto longest = [](const Literal_T &lhs, const Literal_T &rhs) -> const Literal_T&
+    {
+        return rhs.size() > lhs.size() ? rhs : lhs;
+    };
+
+    std::stack <Literals> literals;
+
+    for(const Exp_value_T &chr : m_postfix)
+    {
+        if(chr.second == CLASS_VAL)
+        {
+            literals.push({false, Literal_T(), Literal_T(), Literal_T()});
+
+            continue;
+        }
+
+        if(is_character(chr))
+        {
+            const Literal_T literal(1, chr.first);
+
+            literals.push({true, literal, literal, literal});
+
+            continue;
+        }
+
+        if(chr.second == STAR_VAL || chr.second == QUEST_VAL)
+        {
+            // the empty word belongs to E* and E?
+            literals.top() = {false, Literal_T(), Literal_T(), Literal_T()};
+        }
+        else if(chr.second == REPEAT_VAL)
+        {
+            // only single positions are left repeated, see expand_repeats
+            Literals &x = literals.top();
+
+            const std::size_t min = m_repeats[chr.index].first;
+            const std::size_t max = m_repeats[chr.index].second;
+
+            if(!x.exact || min == 0)
+            {
+                x = {false, Literal_T(), Literal_T(), Literal_T()};
+            }
+            else
+            {
+                x.exact = min == max;
+                x.prefix = Literal_T(std::min(min, max_size + 1), x.prefix[0]);
+                x.suffix = x.prefix;
+                x.required = x.prefix;
+            }
+        }
+        else if(chr.second == PLUS_VAL)
+        {
+            // E+ starts, ends with and contains what E does
+            literals.top().exact = false;
+        }
+        else if(chr.second == UNION_VAL)
+        {
+            const Literals G = std::move(literals.top());
+            literals.pop();
+            Literals &F = literals.top();
+
+            if(F.exact && G.exact && F.prefix == G.prefix)
+            {
+                continue;
+            }
+
+            std::size_t prefix = 0;
+            while(prefix < F.prefix.size() && prefix < G.prefix.size() && F.prefix[prefix] == G.prefix[prefix])
+            {
+                ++prefix;
+            }
+
+            std::size_t suffix = 0;
+            while(
+                suffix < F.suffix.size() && suffix < G.suffix.size() &&
+                F.suffix[F.suffix.size() - suffix - 1] == G.suffix[G.suffix.size() - suffix - 1]
+            )
+            {
+                ++suffix;
+            }
+
+            F.exact = false;
+            F.prefix.resize(prefix);
+            F.suffix.erase(0, F.suffix.size() - suffix);
+
+            // one required literal inside the other is required by both
+            if(F.required.find(G.required) != Literal_T::npos)
+            {
+                F.required = G.required;
+            }
+            else if(G.required.find(F.required) == Literal_T::npos)
+            {
+                F.required.clear();
+            }
+
+            F.required = longest(F.required, longest(F.prefix, F.suffix));
+        }
+        else if(chr.second == CONCAT_VAL)
+        {
+            const Literals G = std::move(literals.top());
+            literals.pop();
+            Literals &F = literals.top();
+
+            F.required = longest(longest(F.required, G.required), F.suffix + G.prefix);
+
+            if(F.exact)
+            {
+                F.prefix += G.prefix;
+            }
+
+            F.suffix = G.exact
+                ? F.suffix + G.suffix
+                : G.suffix;
+
+            F.exact = F.exact && G.exact;
+        }
+        else
+        {
+            continue;
+        }
+
+        // any piece of a literal still is one
+        Literals &top = literals.top();
+        if(top.prefix.size() > max_size || top.suffix.size() > max_size || top.required.size() > max_size)
+        {
+            top.exact = false;
+            top.prefix.resize(std::min(top.prefix.size(), max_size));
+            top.suffix.erase(0, top.suffix.size() - std::min(top.suffix.size(), max_size));
+            top.required.resize(std::min(top.required.size(), max_size));
+        }
+    }
+
+    if(!literals.empty())
+    {
+        m_prefix = std::move(literals.top().prefix);
+        m_required = std::move(literals.top().required);
+    }
+};
+
+
+// the symbols of First, and the byte prefilter
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::compute_starts()
+{
+    m_starts.assign(m_char_masks.size(), false);
+
+    State_T starts = m_NFA[0];
+    starts.reset(0);
+
+    for(std::size_t symbol = 0; symbol < m_char_masks.size(); ++symbol)
+    {
+        m_starts[symbol] = m_char_masks[symbol].intersects(starts);
+    }
+
+    if constexpr (BYTE_UNITS)
+    {
+        Prefilter::Table_T table;
+        for(std::size_t unit = 0; unit < table.size(); ++unit)
+        {
+            table[unit] = m_starts[m_symbol_map[unit]];
+        }
+
+        m_prefilter = Prefilter(
+            table,
+            Prefilter::Literal_T(m_prefix.begin(), m_prefix.end()),
+            Prefilter::Literal_T(m_required.begin(), m_required.end())
+        );
+    }
+};
+
+
+// subset construction over every symbol, starting from the start set,
+// dropped as soon as it needs more states than the budget
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::compute_DFA()
+{
+    const std::size_t budget = std::min(m_options.dfa_states, Eager_DFA::MAX_STATES);
+    if(budget == 0)
+    {
+        return;
+    }
+
+    Eager_DFA dfa(m_char_masks.size());
+
+    // the keys are node based, so pointers to them stay valid
+    std::unordered_map <State_T, Eager_DFA::Id_T> ids;
+    std::vector <const State_T*> states;
+
+    states.push_back(&ids.emplace(m_NFA[0], dfa.add(m_NFA[0].test(0))).first->first);
+
+    State_T next(m_size + 1);
+    State_T active(m_size + 1);
+
+    for(std::size_t id = 0; id < states.size(); ++id)
+    {
+        for(std::size_t symbol = 0; symbol < m_char_masks.size(); ++symbol)
+        {
+            step(m_NFA, *states[id], symbol, next, active);
+
+            auto found = ids.find(next);
+            if(found == ids.end())
+            {
+                if(states.size() == budget)
+                {
+                    return;
+                }
+
+                found = ids.emplace(next, dfa.add(next.test(0))).first;
+                states.push_back(&found->first);
+            }
+
+            dfa.link(static_cast <Eager_DFA::Id_T>(id), symbol, found->second);
+        }
+    }
+
+    dfa.minimize();
+
+    m_DFA = std::move(dfa);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Sample_T>
+std::size_t Regex <String_T, Trace_T>::skip(
+    const Sample_T &sample, std::size_t from, const std::size_t last, const bool prefix
+) const
+{
+    constexpr bool contiguous = std::is_same <Sample_T, View_T>::value;
+
+    if constexpr (contiguous && BYTE_UNITS)
+    {
+        const unsigned char *data = reinterpret_cast <const unsigned char*>(sample.data());
+
+        // an occurrence starting before last may end past it
+        if(prefix && m_prefilter.prefix_size())
+        {
+            return std::min(
+                m_prefilter.find_prefix(data, std::min(sample.size(), last + m_prefilter.prefix_size() - 1), from),
+                last
+            );
+        }
+
+        return std::min(m_prefilter.find_start(data, last, from), last);
+    }
+    else
+    {
+        if constexpr (contiguous)
+        {
+            if(prefix && m_prefix.size() > 1)
+            {
+                return std::min(
+                    sample.substr(0, std::min(sample.size(), last + m_prefix.size() - 1)).find(m_prefix, from),
+                    last
+                );
+            }
+        }
+
+        while(from < last && !m_starts[symbol(sample[from])])
+        {
+            ++from;
+        }
+
+        return from;
+    }
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Sample_T>
+bool Regex <String_T, Trace_T>::viable(const Sample_T &sample, const std::size_t from) const
+{
+    if constexpr (std::is_same <Sample_T, View_T>::value && BYTE_UNITS)
+    {
+        return m_prefilter.viable(reinterpret_cast <const unsigned char*>(sample.data()), sample.size(), from);
+    }
+    else if constexpr (std::is_same <Sample_T, View_T>::value)
+    {
+        return m_required.empty() || sample.find(m_required, from) != View_T::npos;
+    }
+    else
+    {
+        return true;
+    }
+};
+
+
+// index of chr's mask in m_char_masks
+template <typename String_T, typename Trace_T>
+std::size_t Regex <String_T, Trace_T>::symbol(const Char_T chr) const noexcept
+{
+    if constexpr (BYTE_UNITS)
+    {
+        return m_symbol_map[code_unit(chr)];
+    }
+    else
+    {
+        return m_symbol_map[std::upper_bound(m_alphabet.begin(), m_alphabet.end(), code_unit(chr)) - m_alphabet.begin()];
+    }
+};
+
+
+// to = union of the follow sets of every state in (from & B[chr])
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::step(const NFA_T &follow, const State_T &from, const std::size_t symbol, State_T &to, State_T &active) const
+{
+    active.assign_and(from, m_char_masks[symbol]);
+
+    to.reset();
+
+    // the last chain whose exits were taken
+    std::size_t shared = NO_LIMIT;
+
+    // bit 0 is the accepting flag, not a state
+    for(const std::size_t itr : active.ones(1))
+    {
+        if(follow[itr].size())
+        {
+            to |= follow[itr];
+
+            continue;
+        }
+
+        // a copy of a chain, see m_exits
+        to.set_unchecked(itr + 1);
+
+        if(m_exits[itr] != NO_LIMIT && m_exits[itr] != shared)
+        {
+            shared = m_exits[itr];
+            to |= follow[shared];
+        }
+    }
+};
+
+
+// (re)builds context for this regex, only allocates the first time around
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::prepare(Context &context) const
+{
+    if(context.m_owner != m_identity.value())
+    {
+        context = Context(*this);
+    }
+};
+
+
+template <typename String_T, typename Trace_T>
+typename Regex <String_T, Trace_T>::Context& Regex <String_T, Trace_T>::local_context()
+{
+    thread_local Context context;
+
+    return context;
+};
+
+
+// picks the fixed width NFA chosen at construction, if any, and hands function
+// (forward, reverse) engines; reverse is the forward one when it wasnt built
+template <typename String_T, typename Trace_T>
+template <typename Function_T>
+decltype(auto) Regex <String_T, Trace_T>::with_engine(Context &context, Function_T &&function) const
+{
+    switch(m_fixed.index())
+    {
+        case 1:
+            return function(std::get <1>(m_fixed), fixed_reverse <1>());
+        case 2:
+            return function(std::get <2>(m_fixed), fixed_reverse <2>());
+        case 3:
+            return function(std::get <3>(m_fixed), fixed_reverse <3>());
+        default:
+            return function(
+                Bitset_Engine(*this, context, m_NFA),
+                Bitset_Engine(*this, context, m_reverse_NFA.empty() ? m_NFA : m_reverse_NFA)
+            );
+    }
+};
+
+
+template <typename String_T, typename Trace_T>
+template <std::size_t Index>
+const auto& Regex <String_T, Trace_T>::fixed_reverse() const
+{
+    if(m_fixed_reverse.index() == Index)
+    {
+        return std::get <Index>(m_fixed_reverse);
+    }
+
+    return std::get <Index>(m_fixed);
+};
+
+
+// hands function a (current, next) pair of state sets: the preallocated ones
+// of the context for the bitset NFA, plain stack words for the fixed width ones
+template <typename String_T, typename Trace_T>
+template <typename Engine_T, typename Function_T>
+decltype(auto) Regex <String_T, Trace_T>::with_buffers(const Engine_T &engine, Context &context, Function_T &&function)
+{
+    if constexpr (std::is_same <typename Engine_T::Set_T, State_T>::value)
+    {
+        return function(context.m_current, context.m_next);
+    }
+    else
+    {
+        typename Engine_T::Set_T current = engine.empty();
+        typename Engine_T::Set_T next = engine.empty();
+
+        return function(current, next);
+    }
+};
+
+
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::match(const View_T word) const
+{
+    return match_sample(word, local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::match(const View_T word, Context &context) const
+{
+    return match_sample(word, context);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+bool Regex <String_T, Trace_T>::match(const Iterator_T first, const Iterator_T last) const
+{
+    return match_sample(Sample_Range <Iterator_T>(first, last), local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+bool Regex <String_T, Trace_T>::match(const Iterator_T first, const Iterator_T last, Context &context) const
+{
+    return match_sample(Sample_Range <Iterator_T>(first, last), context);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Sample_T>
+bool Regex <String_T, Trace_T>::match_sample(const Sample_T &word, Context &context) const
+{
+    prepare(context);
+
+    const bool result = run_match(word.begin(), word.end(), context);
+
+    Trace_T::matched(word, result);
+
+    return result;
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+bool Regex <String_T, Trace_T>::run_match(const Iterator_T first, const Iterator_T last, Context &context) const
+{
+    if(!m_DFA.empty())
+    {
+        return eager_match(first, last);
+    }
+
+    if(m_options.dfa_cache_limit)
+    {
+        return lazy_match(first, last, context);
+    }
+
+    return with_engine(context, [&](const auto &engine, const auto&) -> bool
+    {
+        return with_buffers(engine, context, [&](auto &state_simulator, auto &transition) -> bool
+        {
+            engine.start(state_simulator);
+
+            return nfa_match(engine, state_simulator, transition, first, last);
+        });
+    });
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Engine_T, typename Iterator_T>
+bool Regex <String_T, Trace_T>::nfa_match(
+    const Engine_T &engine,
+    typename Engine_T::Set_T &state_simulator, typename Engine_T::Set_T &transition,
+    Iterator_T first, const Iterator_T last
+) const
+{
+    for(; first != last; ++first)
+    {
+        // nothing can be matched from here on
+        if(engine.dead(state_simulator))
+        {
+            return false;
+        }
+
+        engine.step(state_simulator, symbol(*first), transition);
+
+        std::swap(state_simulator, transition);
+    }
+
+    return engine.accepting(state_simulator);
+};
+
+
+// same walk as nfa_match, but every state set is computed only once
+// and afterwards costs a single table lookup per character
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+bool Regex <String_T, Trace_T>::lazy_match(Iterator_T first, const Iterator_T last, Context &context) const
+{
+    using Id_T = typename DFA_T::Id_T;
+
+    DFA_T &dfa = context.m_dfa;
+    Bitset_Engine engine(*this, context, m_NFA);
+
+    Id_T current = dfa.intern(m_NFA[0]);
+    if(current == DFA_T::UNKNOWN)
+    {
+        dfa.flush();
+        current = dfa.intern(m_NFA[0]);
+
+        // the limit cant even hold the start state
+        if(current == DFA_T::UNKNOWN)
+        {
+            engine.start(context.m_current);
+
+            return nfa_match(engine, context.m_current, context.m_next, first, last);
+        }
+    }
+
+    for(; first != last; ++first)
+    {
+        // nothing can be matched from here on
+        if(dfa.dead(current))
+        {
+            return false;
+        }
+
+        const std::size_t column = symbol(*first);
+
+        Id_T next = dfa.next(current, column);
+        if(next == DFA_T::UNKNOWN)
+        {
+            engine.step(dfa.state(current), column, context.m_current);
+
+            next = dfa.intern(context.m_current);
+            if(next == DFA_T::UNKNOWN)
+            {
+                // cache is full, drop it and finish this input on the bitsets
+                dfa.flush();
+
+                return nfa_match(engine, context.m_current, context.m_next, std::next(first), last);
+            }
+
+            dfa.link(current, column, next);
+        }
+
+        current = next;
+    }
+
+    return dfa.accepting(current);
+};
+
+
+// the whole DFA is there, nothing is left to compute or cache
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+bool Regex <String_T, Trace_T>::eager_match(Iterator_T first, const Iterator_T last) const
+{
+    Eager_DFA::Id_T current = 0;
+
+    for(; first != last; ++first)
+    {
+        // nothing can be matched from here on
+        if(m_DFA.dead(current))
+        {
+            return false;
+        }
+
+        current = m_DFA.next(current, symbol(*first));
+    }
+
+    return m_DFA.accepting(current);
+};
+
+
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::search(const View_T sample) const
+{
+    return search(sample, local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::search(const View_T sample, Context &context) const
+{
+    // the first match settles it
+    return search_each(sample, [](const std::size_t, const std::size_t)
+    {
+        return false;
+    }, context) != 0;
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+bool Regex <String_T, Trace_T>::search(const Iterator_T first, const Iterator_T last) const
+{
+    return search(first, last, local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+bool Regex <String_T, Trace_T>::search(const Iterator_T first, const Iterator_T last, Context &context) const
+{
+    return search_each(first, last, [](const std::size_t, const std::size_t)
+    {
+        return false;
+    }, context) != 0;
+};
+
+
+template <typename String_T, typename Trace_T>
+std::vector <Match> Regex <String_T, Trace_T>::search_results(const View_T sample, const std::size_t max_res) const
+{
+    return results_sample(sample, max_res, local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+std::vector <Match> Regex <String_T, Trace_T>::search_results(const View_T sample, const std::size_t max_res, Context &context) const
+{
+    return results_sample(sample, max_res, context);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+std::vector <Match> Regex <String_T, Trace_T>::search_results(
+    const Iterator_T first, const Iterator_T last, const std::size_t max_res
+) const
+{
+    return results_sample(Sample_Range <Iterator_T>(first, last), max_res, local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T>
+std::vector <Match> Regex <String_T, Trace_T>::search_results(
+    const Iterator_T first, const Iterator_T last, const std::size_t max_res, Context &context
+) const
+{
+    return results_sample(Sample_Range <Iterator_T>(first, last), max_res, context);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Sample_T>
+std::vector <Match> Regex <String_T, Trace_T>::results_sample(
+    const Sample_T &sample, const std::size_t max_res, Context &context
+) const
+{
+    std::vector <Match> results;
+
+    if(max_res != 0)
+    {
+        search_sample(sample, [&](const std::size_t begin, const std::size_t end) -> bool
+        {
+            results.push_back({begin, end});
+
+            return results.size() < max_res;
+        }, context);
+    }
+
+    return results;
+};
+
+
+template <typename String_T, typename Trace_T>
+std::size_t Regex <String_T, Trace_T>::search_results(const View_T sample, Match *results, const std::size_t max_res) const
+{
+    return search_results(sample, results, max_res, local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+std::size_t Regex <String_T, Trace_T>::search_results(
+    const View_T sample, Match *results, const std::size_t max_res, Context &context
+) const
+{
+    if(max_res == 0)
+    {
+        return 0;
+    }
+
+    std::size_t max_left = max_res;
+
+    return search_sample(sample, [&](const std::size_t begin, const std::size_t end) -> bool
+    {
+        *results++ = {begin, end};
+
+        return --max_left != 0;
+    }, context);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+std::size_t Regex <String_T, Trace_T>::search_each(const View_T sample, Visitor_T &&visitor) const
+{
+    return search_sample(sample, std::forward <Visitor_T>(visitor), local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+std::size_t Regex <String_T, Trace_T>::search_each(const View_T sample, Visitor_T &&visitor, Context &context) const
+{
+    return search_sample(sample, std::forward <Visitor_T>(visitor), context);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T, typename Visitor_T>
+std::size_t Regex <String_T, Trace_T>::search_each(const Iterator_T first, const Iterator_T last, Visitor_T &&visitor) const
+{
+    return search_sample(Sample_Range <Iterator_T>(first, last), std::forward <Visitor_T>(visitor), local_context());
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Iterator_T, typename Visitor_T>
+std::size_t Regex <String_T, Trace_T>::search_each(
+    const Iterator_T first, const Iterator_T last, Visitor_T &&visitor, Context &context
+) const
+{
+    return search_sample(Sample_Range <Iterator_T>(first, last), std::forward <Visitor_T>(visitor), context);
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Sample_T, typename Visitor_T>
+std::size_t Regex <String_T, Trace_T>::search_sample(const Sample_T &sample, Visitor_T &&visitor, Context &context) const
+{
+    prepare(context);
+
+    // the drivers want to know whether to go on
+    const auto found = [&](const std::size_t begin, const std::size_t end) -> bool
+    {
+        Trace_T::found(sample, begin, end);
+
+        if constexpr (std::is_void <decltype(visitor(begin, end))>::value)
+        {
+            visitor(begin, end);
+
+            return true;
+        }
+        else
+        {
+            return static_cast <bool>(visitor(begin, end));
+        }
+    };
+
+    const std::size_t count = with_engine(context, [&](const auto &forward, const auto &reverse) -> std::size_t
+    {
+        if(m_reverse_NFA.empty())
+        {
+            return nfa_search(forward, sample, context, found, NO_LIMIT);
+        }
+
+        return reverse_search(forward, reverse, sample, context, found);
+    });
+
+    Trace_T::searched(sample, count);
+
+    return count;
+};
+
+
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+typename Regex <String_T, Trace_T>::template Stream <std::decay_t <Visitor_T>>
+Regex <String_T, Trace_T>::stream(Visitor_T &&visitor) const
+{
+    return Stream <std::decay_t <Visitor_T>>(*this, std::forward <Visitor_T>(visitor));
+};
+
+
+template <typename String_T, typename Trace_T>
+std::size_t Regex <String_T, Trace_T>::dfa_states() const noexcept
+{
+    return m_DFA.size();
+};
+
+
+// every chunk is searched on its own, as if the input started there, then the
+// chunks are walked in order to keep only what a serial search would find:
+// a chunk's matches are taken from the first one the serial search would
+// also resume into, the chunk is searched again from where the serial search
+// resumes if there is none
+template <typename String_T, typename Trace_T>
+std::vector <Match> Regex <String_T, Trace_T>::parallel_search(const View_T sample, std::size_t threads) const
+{
+    if(threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // a few chunks per thread to even out the load
+    const std::size_t chunk_size = std::max(m_options.parallel_chunk, sample.size() / (threads * 4) + 1);
+    const std::size_t chunk_count = (sample.size() + chunk_size - 1) / chunk_size;
+
+    Context context(*this);
+
+    if(threads == 1 || chunk_count <= 1)
+    {
+        return search_results(sample, NO_LIMIT, context);
+    }
+
+    std::vector <std::vector <Match>> chunks(chunk_count);
+    std::atomic <std::size_t> next_chunk(0);
+
+    const auto worker = [&]()
+    {
+        Context context(*this);
+
+        for(std::size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+        {
+            const std::size_t first = chunk * chunk_size;
+            const std::size_t last = std::min(first + chunk_size, sample.size());
+
+            search_chunk(sample, first, last, context, chunks[chunk]);
+        }
+    };
+
+    std::vector <std::thread> pool;
+    for(std::size_t itr = 1; itr < std::min(threads, chunk_count); ++itr)
+    {
+        pool.emplace_back(worker);
+    }
+
+    worker();
+
+    for(std::thread &thread : pool)
+    {
+        thread.join();
+    }
+
+    std::vector <Match> results;
+
+    // where the serial search goes on from, no match starts in between
+    std::size_t resume = 0;
+
+    for(std::size_t chunk = 0; chunk < chunk_count; ++chunk)
+    {
+        const std::size_t first = chunk * chunk_size;
+        const std::size_t last = std::min(first + chunk_size, sample.size());
+
+        // a match ran over the whole chunk
+        if(resume >= last)
+        {
+            continue;
+        }
+
+        const std::vector <Match> &found = chunks[chunk];
+        auto itr = found.begin();
+
+        // the chunk's own search went on from from, the first match it found
+        // past resume is the serial one if it resumed at or before resume
+        std::size_t from = first;
+        for(; itr != found.end() && itr->begin < resume; ++itr)
+        {
+            from = itr->end;
+        }
+
+        if(from <= resume)
+        {
+            results.insert(results.end(), itr, found.end());
+        }
+        else
+        {
+            search_chunk(sample, resume, last, context, results);
+        }
+
+        if(!results.empty())
+        {
+            resume = std::max(resume, results.back().end);
+        }
+
+        resume = std::max(resume, last);
+    }
+
+    for(const Match &match : results)
+    {
+        Trace_T::found(sample, match.begin, match.end);
+    }
+
+    Trace_T::searched(sample, results.size());
+
+    return results;
+};
+
+
+// appends the matches of sample[first, ...) starting before last
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::search_chunk(
+    const View_T sample, const std::size_t first, const std::size_t last, Context &context, std::vector <Match> &results
+) const
+{
+    prepare(context);
+
+    with_engine(context, [&](const auto &forward, const auto&)
+    {
+        nfa_search(forward, sample.substr(first), context, [&](const std::size_t begin, const std::size_t end) -> bool
+        {
+            results.push_back({first + begin, first + end});
+
+            return true;
+        }, last - first);
+    });
+};
+
+
+// leftmost-longest, non overlapping matches, empty ones are ignored.
+// a single simulation of .*R: the start states are OR-ed into the state set
+// at every offset and each state carries the leftmost offset it was started
+// from, so the input is walked once instead of once per start.
+// whenever no state is alive the prefilter jumps to the next offset a match
+// can start at. starts are only tried before limit
+template <typename String_T, typename Trace_T>
+template <typename Engine_T, typename Sample_T, typename Visitor_T>
+std::size_t Regex <String_T, Trace_T>::nfa_search(
+    const Engine_T &engine, const Sample_T &sample, Context &context, Visitor_T &&found, const std::size_t limit
+) const
+{
+    using Set_T = typename Engine_T::Set_T;
+
+    constexpr std::size_t npos = static_cast <std::size_t>(-1);
+
+    std::size_t *tags = context.m_tags.data();
+    std::size_t *next_tags = context.m_next_tags.data();
+
+    std::size_t count = 0;
+
+    return with_buffers(engine, context, [&](Set_T &state, Set_T &transition) -> std::size_t
+    {
+        // best match so far, [begin, end)
+        std::size_t begin = npos;
+        std::size_t end = 0;
+
+        engine.clear(state);
+
+        // the literal every match contains is not there, the whole input is
+        // only read once more by the prefilter
+        if(limit == NO_LIMIT && !viable(sample, 0))
+        {
+            return count;
+        }
+
+        std::size_t itr = 0;
+        while(true)
+        {
+            if(begin == npos && engine.dead(state))
+            {
+                itr = skip(sample, itr, std::min(limit, sample.size()));
+
+                if(itr >= limit || itr >= sample.size())
+                {
+                    break;
+                }
+            }
+
+            if(itr < sample.size())
+            {
+                // once a match is found no later start can be leftmost
+                if(begin == npos && itr < limit)
+                {
+                    engine.inject(state, tags, itr);
+                }
+
+                std::size_t accept = npos;
+
+                engine.step(state, tags, symbol(sample[itr]), transition, next_tags, accept);
+
+                std::swap(state, transition);
+                std::swap(tags, next_tags);
+
+                ++itr;
+
+                // further left, or the same start but longer
+                if(accept != npos && accept <= begin)
+                {
+                    begin = accept;
+                    end = itr;
+                }
+
+                if(begin == npos)
+                {
+                    // no more starts to come and nothing left alive
+                    if(itr >= limit && engine.dead(state))
+                    {
+                        break;
+                    }
+
+                    continue;
+                }
+
+                engine.prune(state, tags, begin);
+
+                if(!engine.dead(state))
+                {
+                    continue;
+                }
+            }
+            else if(begin == npos)
+            {
+                break;
+            }
+
+            // nothing alive can improve on [begin, end) anymore
+            ++count;
+            if(!found(begin, end))
+            {
+                break;
+            }
+
+            // resume right after the match, rescanning what was read past it
+            engine.clear(state);
+            itr = end;
+            begin = npos;
+
+            if(limit == NO_LIMIT && !viable(sample, itr))
+            {
+                break;
+            }
+        }
+
+        return count;
+    });
+};
+
+
+
+
+// same results as nfa_search, found in three plain (untagged) walks:
+// forward over .*R until every thread started before the first match end
+// is dead, recording the match ends; backward over the reverse automaton,
+// restarted at every recorded end, the lowest offset it accepts at being
+// the leftmost start; forward again, anchored there, for the longest end
+template <typename String_T, typename Trace_T>
+template <typename Engine_T, typename Sample_T, typename Visitor_T>
+std::size_t Regex <String_T, Trace_T>::reverse_search(
+    const Engine_T &forward, const Engine_T &reverse, const Sample_T &sample, Context &context, Visitor_T &&found
+) const
+{
+    using Set_T = typename Engine_T::Set_T;
+
+    constexpr std::size_t npos = static_cast <std::size_t>(-1);
+
+    std::vector <std::size_t> &ends = context.m_ends;
+
+    std::size_t count = 0;
+
+    return with_buffers(forward, context, [&](Set_T &state, Set_T &transition) -> std::size_t
+    {
+        std::size_t from = 0;
+        while(from < sample.size() && viable(sample, from))
+        {
+            // match ends, restarting .*R until the first one
+            ends.clear();
+            forward.clear(state);
+
+            for(std::size_t itr = from; itr < sample.size(); ++itr)
+            {
+                if(ends.empty())
+                {
+                    // nothing alive, no need to restart before the next possible start
+                    if(forward.dead(state) && (itr = skip(sample, itr, sample.size())) == sample.size())
+                    {
+                        break;
+                    }
+
+                    forward.restart(state);
+                }
+
+                forward.step(state, symbol(sample[itr]), transition);
+                std::swap(state, transition);
+
+                if(forward.accepting(state))
+                {
+                    ends.push_back(itr + 1);
+                }
+                else if(!ends.empty() && forward.dead(state))
+                {
+                    break;
+                }
+            }
+
+            if(ends.empty())
+            {
+                break;
+            }
+
+            // leftmost start of a match ending at any of the ends
+            std::size_t begin = npos;
+            std::size_t end_itr = ends.size();
+
+            reverse.clear(state);
+
+            for(std::size_t itr = ends.back(); itr-- > from; )
+            {
+                if(end_itr && ends[end_itr - 1] == itr + 1)
+                {
+                    reverse.restart(state);
+                    --end_itr;
+                }
+
+                reverse.step(state, symbol(sample[itr]), transition);
+                std::swap(state, transition);
+
+                if(reverse.accepting(state))
+                {
+                    begin = itr;
+                }
+                else if(!end_itr && reverse.dead(state))
+                {
+                    break;
+                }
+            }
+
+            // longest match from there
+            std::size_t end = begin;
+
+            forward.start(state);
+
+            for(std::size_t itr = begin; itr < sample.size() && !forward.dead(state); ++itr)
+            {
+                forward.step(state, symbol(sample[itr]), transition);
+                std::swap(state, transition);
+
+                if(forward.accepting(state))
+                {
+                    end = itr + 1;
+                }
+            }
+
+            ++count;
+            if(!found(begin, end))
+            {
+                break;
+            }
+
+            from = end;
+        }
+
+        return count;
+    });
+};
+
+
+
+
+/*
+================================================================================
+------------------------------ rgx::Regex::Context -----------------------------
+================================================================================
+*/
 
-    // processed_exp.shrink_to_fit();
-    return std::move(processed_exp);
-};
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T>::Context::Context()
+    :
+    m_owner(Identity::NONE),
+    m_dfa(0, 0)
+{};
 
 
-template <typename String_T>
-typename Regex<String_T>::Exp_T
-Regex<String_T>::process_escape(const String_T &exp) const
-{
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T>::Context::Context(const Regex &regex)
+    :
+    m_owner(regex.m_identity.value()),
+    m_current(regex.m_size + 1),
+    m_next(regex.m_size + 1),
+    m_active(regex.m_size + 1),
+    m_dfa(regex.m_char_masks.size(), regex.m_options.dfa_cache_limit),
+    m_tags(regex.m_size + 1),
+    m_next_tags(regex.m_size + 1)
+{};
 
-    // std::cout << exp;
-    // std::cout << std::endl;
 
-    Exp_T processed_exp;
-    processed_exp.reserve(exp.size());
 
-    std::size_t itr = 0;
-    for(itr; itr < exp.size() - 1; ++itr)
-    {
-        if(exp[itr] == ESCAPE)
-        {
-            processed_exp.push_back({exp[++itr], CHAR_VAL});
-        }
-        else
-        {
-            processed_exp.push_back({exp[itr], op_value(exp[itr])});
-        }
-    }
 
-    if(itr < exp.size())
-    {
-        processed_exp.push_back({exp[itr], op_value(exp[itr])});
-    }
+/*
+================================================================================
+------------------------------ rgx::Regex::Stream ------------------------------
+================================================================================
+*/
 
-    processed_exp.shrink_to_fit();
-    return std::move(processed_exp);
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+Regex <String_T, Trace_T>::Stream <Visitor_T>::Stream(const Regex &regex, Visitor_T visitor)
+    :
+    m_regex(regex),
+    m_visitor(std::move(visitor)),
+    m_context(regex)
+{
+    reset();
 };
 
 
-template <typename String_T>
-typename Regex<String_T>::Exp_T
-Regex<String_T>::process_concat(const Exp_T &exp) const
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+void Regex <String_T, Trace_T>::Stream <Visitor_T>::feed(const Char_T *data, const std::size_t size)
 {
+    m_regex.with_engine(m_context, [&](const auto &engine, const auto&)
+    {
+        with_sets(engine, [&](auto &state, auto &transition)
+        {
+            scan(engine, state, transition, data, data + size);
+        });
+    });
+};
 
-    // std::for_each(exp.begin(), exp.end(), [](auto i)->void {std::cout << i.first;});
-    // std::for_each(exp.begin(), exp.end(), [](auto i)->void {std::cout << (unsigned int)i.second << ' ';});
-    // std::cout << std::endl;
-
-    Exp_T processed_exp;
-    processed_exp.reserve(exp.size() * 2 + 2);
-
-    processed_exp.push_back({OPEN, OPEN_VAL});
 
-    for(const Exp_value_T chr : exp)
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+void Regex <String_T, Trace_T>::Stream <Visitor_T>::finish()
+{
+    m_regex.with_engine(m_context, [&](const auto &engine, const auto&)
     {
-        if(detect_concat(processed_exp.back(), chr))
+        with_sets(engine, [&](auto &state, auto &transition)
         {
-            processed_exp.push_back({CONCAT, CONCAT_VAL});
-        }
+            // settling a match may queue more input to rescan, and so on
+            scan(engine, state, transition, nullptr, nullptr);
 
-        processed_exp.push_back(chr);
-    }
+            while(m_begin != npos)
+            {
+                settle(engine, state);
 
-    processed_exp.push_back({CLOSE, CLOSE_VAL});
+                scan(engine, state, transition, nullptr, nullptr);
+            }
+        });
+    });
 
-    processed_exp.shrink_to_fit();
-    return std::move(processed_exp);
+    reset();
 };
 
 
-// calculates nr of states
-template <typename String_T>
-typename Regex<String_T>::Exp_T
-Regex <String_T>::process_postfix(const Exp_T &exp)
+// the same walk as nfa_search, one character at a time
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+template <typename Engine_T>
+void Regex <String_T, Trace_T>::Stream <Visitor_T>::scan(
+    const Engine_T &engine,
+    typename Engine_T::Set_T &state, typename Engine_T::Set_T &transition,
+    const Char_T *first, const Char_T *last
+)
 {
-    m_size = 0;
+    std::size_t *tags = m_context.m_tags.data();
+    std::size_t *next_tags = m_context.m_next_tags.data();
 
-    // std::for_each(exp.begin(), exp.end(), [](auto i)->void {std::cout << i.first;});
-    // std::for_each(exp.begin(), exp.end(), [](auto i)->void {std::cout << (unsigned int)i.second << ' ';});
-    // std::cout << std::endl;
-
-    Exp_T processed_exp;
-    processed_exp.reserve(exp.size());
-
-    // a fixed size stack would help,
-    // repeated allocations are still expensive
-    // also leads to caching struggles
-    std::stack <Exp_value_T> conversion_stack;
-
-    for(const Exp_value_T chr : exp)
+    while(true)
     {
-        if(is_character(chr))
-        {
-            processed_exp.push_back(chr);
+        Char_T chr;
 
-            ++m_size;    // increment number of states
+        // nothing alive, jump to the next character a match can start with;
+        // a prefix may run over into the next chunk, so only its first one
+        if(m_begin == npos && m_replay_pos == m_replay.size() && first != last && engine.dead(state))
+        {
+            const std::size_t skipped = m_regex.skip(View_T(first, last - first), 0, last - first, false);
 
-            continue;
+            first += skipped;
+            m_offset += skipped;
         }
 
-        if(chr.second == OPEN_VAL)
+        if(m_replay_pos < m_replay.size())
         {
-            conversion_stack.push(chr);
+            chr = m_replay[m_replay_pos++];
+        }
+        else if(first != last)
+        {
+            chr = *first++;
+        }
+        else
+        {
+            break;
+        }
 
-            continue;
+        if(m_begin == npos)
+        {
+            engine.inject(state, tags, m_offset);
         }
 
-        if(is_operator(chr))
+        std::size_t accept = npos;
+
+        engine.step(state, tags, m_regex.symbol(chr), transition, next_tags, accept);
+
+        std::swap(state, transition);
+        std::swap(tags, next_tags);
+
+        ++m_offset;
+
+        if(accept != npos && accept <= m_begin)
         {
-            while(operator_precedence(conversion_stack.top()) >= operator_precedence(chr))
-            {
-                processed_exp.push_back(conversion_stack.top());
-                conversion_stack.pop();
-            }
+            m_begin = accept;
+            m_end = m_offset;
 
-            conversion_stack.push(chr);
+            m_window.clear();
+        }
+        else if(m_begin != npos)
+        {
+            m_window.push_back(chr);
+        }
 
+        if(m_begin == npos)
+        {
             continue;
         }
 
-        while(conversion_stack.top().second != OPEN_VAL)
+        engine.prune(state, tags, m_begin);
+
+        if(engine.dead(state))
         {
-            processed_exp.push_back(conversion_stack.top());
-            conversion_stack.pop();
+            settle(engine, state);
         }
-
-        conversion_stack.pop();
     }
 
-    // processed_exp.shrink_to_fit();
-    return std::move(processed_exp);
+    // the tags live on in the context
+    if(tags != m_context.m_tags.data())
+    {
+        std::swap(m_context.m_tags, m_context.m_next_tags);
+    }
 };
 
 
-
-
-template <typename String_T>
-void Regex <String_T>::compute_NFA(const Exp_T &exp)
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+template <typename Engine_T>
+void Regex <String_T, Trace_T>::Stream <Visitor_T>::settle(const Engine_T &engine, typename Engine_T::Set_T &state)
 {
-    std::for_each(m_postfix.begin(), m_postfix.end(), [](auto i)->void {std::cout << i.first;});
-    std::cout << std::endl;
-    std::for_each(m_postfix.begin(), m_postfix.end(), [](auto i)->void {std::cout << (unsigned int)i.second << ' ';});
-    std::cout << std::endl;
-
-    // std::cout << std::endl << m_size;
-
-    m_NFA.reserve(m_size + 1);
-    m_transition_labels.reserve(m_size + 1);
+    m_visitor(m_begin, m_end);
 
-    std::stack <State_T> first_stack;
-    std::stack <State_T> last_stack;
+    engine.clear(state);
 
-    //indexes that are contained within the stack expression
-    std::stack <State_T> pos_stack;
+    m_offset = m_end;
+    m_begin = npos;
 
-    m_NFA.push_back(State_T(m_size + 1));    //first
-    m_transition_labels.push_back({'/', 0});
+    // rescan what was read past the match, ahead of whatever was still queued
+    m_window.insert(m_window.end(), m_replay.begin() + m_replay_pos, m_replay.end());
+    std::swap(m_window, m_replay);
 
-    std::size_t itr = 1;
-    for(const Exp_value_T chr : exp)
-    {
-        if(is_character(chr))
-        {
-            // each character has a state 
-            m_transition_labels.push_back(chr);
+    m_window.clear();
+    m_replay_pos = 0;
+};
 
-            State_T mask(m_size + 1);
-            mask.set(itr);
 
-            // First(x) = {x}
-            first_stack.push(mask);
-            // Last(x) = {x}
-            last_stack.push(mask);
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+void Regex <String_T, Trace_T>::Stream <Visitor_T>::reset()
+{
+    m_offset = 0;
+    m_begin = npos;
+    m_end = 0;
 
-            pos_stack.push(mask);
+    m_window.clear();
+    m_replay.clear();
+    m_replay_pos = 0;
 
-            // we push the empty bit to its follow() since they come in order
-            m_NFA.push_back(State_T(m_size + 1));
+    m_regex.with_engine(m_context, [&](const auto &engine, const auto&)
+    {
+        using Set_T = typename std::decay_t <decltype(engine)>::Set_T;
 
-            itr++;
+        if constexpr (std::is_same <Set_T, State_T>::value)
+        {
+            engine.clear(m_context.m_current);
         }
         else
         {
-            if(chr.second == STAR_VAL)
-            {
-                // we keep track whether epsilon belongs to the current 
-                // subsequence of RE using the 0th byte
-
-                // First(E*) = First(E+) = First(E)
-                first_stack.top().set(0);
+            m_state = engine.empty();
+            m_transition = engine.empty();
+        }
+    });
+};
 
-                // Last(E*) = Last(E+) = Last(E)
-                last_stack.top().set(0);
 
-                // follow
-                for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
-                    if(pos_stack.top().test(itr) && last_stack.top().test(itr))
-                        m_NFA[itr] |= first_stack.top();
-            }
-            if(chr.second == UNION_VAL)
-            {
-                // First(F | G) = First(F) U First(G)
-                State_T mask = std::move(first_stack.top());
-                first_stack.pop();
-                first_stack.top() |= mask;
+// same as Regex::with_buffers, but the sets outlive the call
+template <typename String_T, typename Trace_T>
+template <typename Visitor_T>
+template <typename Engine_T, typename Function_T>
+decltype(auto) Regex <String_T, Trace_T>::Stream <Visitor_T>::with_sets(const Engine_T&, Function_T &&function)
+{
+    using Set_T = typename Engine_T::Set_T;
 
-                // Last(F | G) = Last(F) U Last(G)
-                mask = std::move(last_stack.top());
-                last_stack.pop();
-                last_stack.top() |= mask;
+    if constexpr (std::is_same <Set_T, State_T>::value)
+    {
+        return function(m_context.m_current, m_context.m_next);
+    }
+    else
+    {
+        return function(std::get <Set_T>(m_state), std::get <Set_T>(m_transition));
+    }
+};
 
-                // positions united
-                mask = std::move(pos_stack.top());
-                pos_stack.pop();
-                pos_stack.top() |= mask;
 
-                // nothing changes for follow
-            }
-            if(chr.second == CONCAT_VAL)
-            {
-                // First(F + G) = First(F) if epsilon DOES NOT belong to L(F);
-                // First(F + G) = First(F) U First(G) if epsilon belongs to L(F)
 
-                State_T mask = std::move(first_stack.top());
-                first_stack.pop();
 
-                State_T firstG = mask;    // save for follow...
+/*
+================================================================================
+------------------------------ rgx::Regex::Bitset_Engine -----------------------
+================================================================================
+*/
 
-                if(first_stack.top().test(0))
-                {
-                    if(!mask.test(0))
-                    {
-                        first_stack.top().reset(0);
-                    }
+template <typename String_T, typename Trace_T>
+Regex <String_T, Trace_T>::Bitset_Engine::Bitset_Engine(const Regex &regex, Context &context, const NFA_T &follow)
+    :
+    m_regex(regex),
+    m_context(context),
+    m_follow(follow)
+{};
 
-                    first_stack.top() |= mask;
-                }
 
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::Bitset_Engine::start(State_T &state) const
+{
+    state = m_follow[0];
+};
 
-                // Last(F + G) = Last(F) if epsilon DOES NOT belong to L(F);
-                // Last(F + G) = Last(F) U Last(G) if epsilon belongs to L(F)
 
-                mask = std::move(last_stack.top());
-                last_stack.pop();
+template <typename String_T, typename Trace_T>
+typename Regex <String_T, Trace_T>::State_T
+Regex <String_T, Trace_T>::Bitset_Engine::empty() const
+{
+    return State_T(m_regex.m_size + 1);
+};
 
-                State_T lastF = last_stack.top();    // save for follow...
 
-                if(mask.test(0))
-                {
-                    if(!last_stack.top().test(0))
-                    {
-                        mask.reset(0);
-                    }
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::Bitset_Engine::clear(State_T &state) const
+{
+    state.reset();
+};
 
-                    last_stack.top() |= mask;
-                }
-                else
-                {
-                    last_stack.emplace(std::move(mask));
-                }
 
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::Bitset_Engine::restart(State_T &state) const
+{
+    state |= m_follow[0];
+};
 
-                // positions concatenated (no difference)
 
-                mask = std::move(pos_stack.top());
-                pos_stack.pop();
-                pos_stack.top() |= mask;
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::Bitset_Engine::step(const State_T &from, const std::size_t symbol, State_T &to) const
+{
+    m_regex.step(m_follow, from, symbol, to, m_context.m_active);
+};
 
 
-                // follow
-                for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
-                {
-                    if(pos_stack.top().test(itr) && lastF.test(itr))
-                    {
-                        m_NFA[itr] |= firstG;
-                    }
-                }
-            }
-        }
-    }
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::Bitset_Engine::inject(State_T &state, std::size_t *tags, const std::size_t tag) const
+{
+    const State_T &start = m_follow[0];
 
-    m_NFA[0] = std::move(first_stack.top());
-    for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
+    // bit 0 is the nullable flag, not a state
+    for(const std::size_t itr : start.ones(1))
     {
-        m_NFA[itr].set(0, last_stack.top().test(itr));
+        if(!state.test_unchecked(itr))
+        {
+            state.set_unchecked(itr);
+            tags[itr] = tag;
+        }
     }
 };
 
 
-template <typename String_T>
-bool Regex <String_T>::match(const String_T &word)
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::Bitset_Engine::step(
+    const State_T &from, const std::size_t *from_tags, const std::size_t symbol,
+    State_T &to, std::size_t *to_tags, std::size_t &accept
+) const
 {
-    State_T state_simulator = m_NFA[0];
+    State_T &active = m_context.m_active;
 
-    std::cout << word << std::endl;
+    active.assign_and(from, m_regex.m_char_masks[symbol]);
 
-    for(const Char_T chr : word)
-    {
-        State_T transition(m_size + 1);
+    to.reset();
 
-        for(std::size_t itr = 1; itr < m_NFA.size(); ++itr)
+    // states reached for the first time take the tag as is, the others keep the smaller one
+    const auto reach = [&](const std::size_t state, const std::size_t tag)
+    {
+        if(!to.test_unchecked(state))
         {
-            // break if transition is null
-            if(state_simulator.test(itr) && m_transition_labels[itr].first == chr)
-            {
-                transition |= m_NFA[itr];
-            }
+            to.set_unchecked(state);
+            to_tags[state] = tag;
         }
-        state_simulator = std::move(transition);
-
-        std::cout << chr << " " << state_simulator << std::endl;
-    }
+        else if(tag < to_tags[state])
+        {
+            to_tags[state] = tag;
+        }
+    };
 
-    return state_simulator.test(0);
-};
+    // the follow set of shared is taken once, with the smallest tag of the
+    // chain copies leaving through it
+    std::size_t shared = NO_LIMIT;
+    std::size_t shared_tag = NO_LIMIT;
 
+    const auto leave = [&]()
+    {
+        if(shared == NO_LIMIT)
+        {
+            return;
+        }
 
-template <typename String_T>
-bool Regex <String_T>::search(const String_T &sample)
-{
-    // empty words will be ignored
+        const State_T &follow = m_follow[shared];
 
-    // std::cout << "Searching for expression: \"" << infixExp_ <<"\" on given string..." << std::endl;
+        if(follow.test_unchecked(0) && shared_tag < accept)
+        {
+            accept = shared_tag;
+        }
 
-    std::size_t count = 0;
-    std::list <std::pair <State_T, std::pair <std::size_t, std::size_t>>> matches; // pair(transition, pair(begin, end))
+        for(const std::size_t jtr : follow.ones(1))
+        {
+            reach(jtr, shared_tag);
+        }
+    };
 
-    for(std::size_t itr = 0; itr < sample.size(); ++itr)
+    for(const std::size_t itr : active.ones(1))
     {
-        matches.push_back({m_NFA[0], {itr, -1}});
+        const std::size_t tag = from_tags[itr];
+        std::size_t exit = itr;
 
-        auto match_itr = matches.begin();
-        while(match_itr != matches.end())
+        // a copy of a chain, see m_exits
+        if(!m_follow[itr].size())
         {
-            State_T transition(m_size + 1);
-            for(std::size_t jtr = 1; jtr < m_NFA.size(); ++jtr)
-            {
-                if(match_itr->first.test(jtr) && m_transition_labels[jtr].first == sample[itr])
-                {
-                    transition |= m_NFA[jtr];
-                }
-            }
+            reach(itr + 1, tag);
 
-            if(transition.none())
-            {
-                // cant transition (haha transphobic jokes am i right) :/ yikes bro
-                if(match_itr->second.second != -1)
-                {
-                    std::cout << "Found: \""<< sample.substr(match_itr->second.first, match_itr->second.second - match_itr->second.first + 1) << "\" at index " << match_itr->second.first << std::endl;
-                    ++count;
-                }
-                match_itr = matches.erase(match_itr);
-            }
-            else
+            exit = m_regex.m_exits[itr];
+            if(exit == NO_LIMIT)
             {
-                match_itr->first = std::move(transition); // new state
-                if(transition.test(0))
-                {
-                    match_itr->second.second = itr; // bigger match length   
-                    match_itr = matches.erase(std::next(match_itr, 1), matches.end());
-                    break;
-                }
-                match_itr = std::next(match_itr);
+                continue;
             }
         }
+
+        if(exit != shared)
+        {
+            leave();
+
+            shared = exit;
+            shared_tag = tag;
+        }
+        else if(tag < shared_tag)
+        {
+            shared_tag = tag;
+        }
     }
-    if(matches.begin() != matches.end() && matches.begin()->second.second != -1)
+
+    leave();
+};
+
+
+template <typename String_T, typename Trace_T>
+void Regex <String_T, Trace_T>::Bitset_Engine::prune(State_T &state, const std::size_t *tags, const std::size_t limit)
+{
+    for(const std::size_t itr : state.ones())
     {
-        std::cout << "Found: \""<< sample.substr(matches.begin()->second.first, matches.begin()->second.second - matches.begin()->second.first + 1) << "\" at index " << matches.begin()->second.first << std::endl;
-        ++count;
+        if(tags[itr] > limit)
+        {
+            state.reset_unchecked(itr);
+        }
     }
-    if(count == 0)
-    {
-        std::cout << "No matches." << std::endl;
+};
 
-        return false;
-    }
-    else
-    {
-        std::cout << "Found a total of " << count << " matches." << std::endl;
 
-        return true;
-    }
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::Bitset_Engine::accepting(const State_T &state)
+{
+    return state.test(0);
+};
+
+
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::Bitset_Engine::dead(const State_T &state)
+{
+    return state.none();
 };
 
 
@@ -574,78 +3552,82 @@ bool Regex <String_T>::search(const String_T &sample)
 ================================================================================
 */
 
-template <typename String_T>
+template <typename String_T, typename Trace_T>
 constexpr bool
-Regex <String_T>::is_operator(const Exp_value_T chr) noexcept
+Regex <String_T, Trace_T>::is_operator(const Exp_value_T chr) noexcept
 {    
-    return 1 <= chr.second && chr.second <= 4; 
+    return (1 <= chr.second && chr.second <= 4) || chr.second == QUEST_VAL || chr.second == REPEAT_VAL;
 };
 
-template <typename String_T>
-bool Regex <String_T>::is_operator(const Char_T chr) const noexcept
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::is_operator(const Char_T chr) const noexcept
 {    
-    return chr == UNION || chr == STAR || chr == CONCAT;
+    return chr == UNION || chr == STAR || chr == PLUS || chr == QUEST;
 };
 
 
-template <typename String_T>
+template <typename String_T, typename Trace_T>
 constexpr bool
-Regex <String_T>::is_bracket(const Exp_value_T chr) noexcept
+Regex <String_T, Trace_T>::is_bracket(const Exp_value_T chr) noexcept
 {
     return chr.second == OPEN_VAL || chr.second == CLOSE_VAL;
 };
 
-template <typename String_T>
-bool Regex <String_T>::is_bracket(const Char_T chr) const noexcept
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::is_bracket(const Char_T chr) const noexcept
 {
     return chr == OPEN || chr == CLOSE;
 };
 
 
-template <typename String_T>
+template <typename String_T, typename Trace_T>
 constexpr bool
-Regex <String_T>::is_character(const Exp_value_T chr) noexcept
+Regex <String_T, Trace_T>::is_character(const Exp_value_T chr) noexcept
 {
-    return chr.second == CHAR_VAL;
+    return chr.second == CHAR_VAL || chr.second == CLASS_VAL;
 };
 
-template <typename String_T>
-bool Regex <String_T>::is_character(const Char_T chr) const noexcept
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::is_character(const Char_T chr) const noexcept
 {
     return !(is_operator(chr) || is_bracket(chr) || chr == ESCAPE);
 };
 
 
-template <typename String_T>
+template <typename String_T, typename Trace_T>
 constexpr bool
-Regex <String_T>::detect_concat(const Exp_value_T chr1, const Exp_value_T chr2)
+Regex <String_T, Trace_T>::detect_concat(const Exp_value_T chr1, const Exp_value_T chr2)
 noexcept
 {
     return (
-        chr1.second == CHAR_VAL || chr1.second == CLOSE_VAL ||
-        chr1.second == STAR_VAL || chr1.second == PLUS_VAL
+        is_character(chr1) || chr1.second == CLOSE_VAL ||
+        chr1.second == STAR_VAL || chr1.second == PLUS_VAL ||
+        chr1.second == QUEST_VAL || chr1.second == REPEAT_VAL
     ) && (
-        chr2.second == CHAR_VAL || chr2.second == OPEN_VAL
+        is_character(chr2) || chr2.second == OPEN_VAL
     );
 };
 
-template <typename String_T>
-bool Regex <String_T>::detect_concat(const Char_T chr1, const Char_T chr2)
+template <typename String_T, typename Trace_T>
+bool Regex <String_T, Trace_T>::detect_concat(const Char_T chr1, const Char_T chr2)
 const noexcept
 {
     return(
-        is_character(chr1) || chr1 == CLOSE || chr1 == STAR || chr1 == PLUS
+        is_character(chr1) || chr1 == CLOSE || chr1 == STAR || chr1 == PLUS || chr1 == QUEST
     ) && (
         is_character(chr2) || chr2 == OPEN
     );
 };
 
 
-template <typename String_T>
+template <typename String_T, typename Trace_T>
 constexpr uint8_t
-Regex <String_T>::operator_precedence(const Exp_value_T chr) noexcept
+Regex <String_T, Trace_T>::operator_precedence(const Exp_value_T chr) noexcept
 {
-    if(chr.second == STAR_VAL || chr.second == PLUS_VAL)
+    if(
+        chr.second == STAR_VAL || chr.second == PLUS_VAL ||
+        chr.second == QUEST_VAL || chr.second == REPEAT_VAL
+    )
     {
         return 3;
     }
@@ -663,20 +3645,15 @@ Regex <String_T>::operator_precedence(const Exp_value_T chr) noexcept
     return 0;
 };
 
-template <typename String_T>
-uint8_t Regex <String_T>::operator_precedence(const Char_T chr)
+template <typename String_T, typename Trace_T>
+uint8_t Regex <String_T, Trace_T>::operator_precedence(const Char_T chr)
 const noexcept
 {
-    if(chr == STAR || chr == PLUS)
+    if(chr == STAR || chr == PLUS || chr == QUEST)
     {
         return 3;
     }
 
-    if(chr == CONCAT)
-    {
-        return 2;
-    }
-
     if(chr == UNION)
     {
         return 1;
@@ -686,8 +3663,8 @@ const noexcept
 };
 
 
-template <typename String_T>
-uint8_t Regex <String_T>::op_value(const Char_T chr) const noexcept
+template <typename String_T, typename Trace_T>
+uint8_t Regex <String_T, Trace_T>::op_value(const Char_T chr) const noexcept
 {
     if(chr == UNION)
         return UNION_VAL;
@@ -698,8 +3675,8 @@ uint8_t Regex <String_T>::op_value(const Char_T chr) const noexcept
     if(chr == PLUS)
         return PLUS_VAL;
 
-    if(chr == CONCAT)
-        return CONCAT_VAL;
+    if(chr == QUEST)
+        return QUEST_VAL;
 
     if(chr == OPEN)
         return OPEN_VAL;
@@ -714,5 +3691,13 @@ uint8_t Regex <String_T>::op_value(const Char_T chr) const noexcept
 };
 
 
+template <typename String_T, typename Trace_T>
+constexpr std::size_t
+Regex <String_T, Trace_T>::code_unit(const Char_T chr) noexcept
+{
+    return static_cast <std::size_t>(static_cast <std::make_unsigned_t <Char_T>>(chr));
+};
+
+
 
 }
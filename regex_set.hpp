@@ -0,0 +1,655 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+#include <unordered_map>
+
+#include "regex.hpp"
+
+
+
+namespace rgx
+{
+
+
+
+// many patterns compiled into one Glushkov automaton, so a single scan tells
+// which of them match.
+// every pattern is compiled on its own, then their positions are laid out one
+// after the other in a shared position space. the single accepting flag (bit 0)
+// of Regex becomes one flag per pattern: bits [0, size()) are the accept mask,
+// pattern k's follow sets carry bit k where Regex's carried bit 0
+template <typename String_T = std::string>
+class RegexSet
+{
+    using Regex_T       = Regex <String_T>;
+    using Char_T        = typename String_T::value_type;
+    using Traits_T      = typename String_T::traits_type;
+    using View_T        = typename std::basic_string_view <Char_T, Traits_T>;
+    using State_T       = typename bit::Bitset <uint64_t>;
+    using NFA_T         = typename std::vector <State_T>;
+
+
+    static constexpr const bool BYTE_UNITS = sizeof(Char_T) == 1;
+
+
+    std::size_t m_patterns;
+
+    // positions plus accept flags
+    std::size_t m_bits;
+
+    // m_NFA[0] is the start set, m_NFA[1, m_patterns) are unused
+    NFA_T m_NFA;
+
+    // B[c], same layout as Regex::m_char_masks
+    NFA_T m_char_masks;
+
+    // the run boundaries of every pattern, same layout as Regex::m_alphabet
+    std::vector <std::size_t> m_alphabet;
+
+    // symbol of every code unit or run, as Regex::m_symbol_map: the units
+    // that are one symbol in every pattern are one symbol of the set
+    std::vector <uint32_t> m_symbol_map;
+
+    std::variant <std::monostate, Fixed_NFA <1>, Fixed_NFA <2>, Fixed_NFA <4>> m_fixed;
+
+    // what a context checks it was built for, see Regex::m_identity
+    const Identity m_identity;
+
+
+    void compute_NFA(const std::vector <Regex_T>&);
+    void compute_masks(const std::vector <Regex_T>&);
+
+    void select_engine();
+
+    std::size_t symbol(const Char_T) const noexcept;
+
+    template <typename Function_T>
+    decltype(auto) with_engine(Function_T&&) const;
+
+    static void shift(const State_T&, State_T&, const std::size_t, const std::size_t);
+
+
+public:
+
+    // scratch space of match and search, see Regex::Context
+    class Context
+    {
+        friend class RegexSet;
+
+        uint64_t m_owner;
+
+        State_T m_current;
+        State_T m_next;
+        State_T m_active;
+
+        // search: every flag reached so far
+        State_T m_seen;
+
+    public:
+
+        Context();
+
+        explicit Context(const RegexSet &);
+    };
+
+
+    explicit RegexSet(const std::vector <String_T> &patterns, const Options & = Options());
+
+
+    std::size_t size() const noexcept;
+
+
+    // the ids (indexes into patterns) of the patterns matching the whole of
+    // word, in ascending order; ids is cleared first
+    void match(const View_T word, std::vector <std::size_t> &ids, Context &context) const;
+    std::vector <std::size_t> match(const View_T word) const;
+
+    // the ids of the patterns with a match somewhere in sample, empty
+    // matches are ignored as in Regex::search
+    void search(const View_T sample, std::vector <std::size_t> &ids, Context &context) const;
+    std::vector <std::size_t> search(const View_T sample) const;
+
+
+private:
+
+    // the bitset NFA behind the same interface as Fixed_NFA
+    class Bitset_Engine
+    {
+        const RegexSet &m_set;
+        Context &m_context;
+
+    public:
+
+        using Set_T = State_T;
+
+        Bitset_Engine(const RegexSet&, Context&);
+
+        void start(Set_T&) const;
+        Set_T empty() const;
+        void clear(Set_T&) const;
+        void restart(Set_T&) const;
+        void step(const Set_T&, const std::size_t, Set_T&) const;
+
+        static bool dead(const Set_T&);
+    };
+
+    template <typename Engine_T>
+    void run_match(const Engine_T&, const View_T, std::vector <std::size_t>&, Context&) const;
+
+    template <typename Engine_T>
+    void run_search(const Engine_T&, const View_T, std::vector <std::size_t>&, Context&) const;
+
+    template <typename Engine_T, typename Function_T>
+    static decltype(auto) with_buffers(const Engine_T&, Context&, Function_T&&);
+
+    // the accept flags set in state, appended to ids
+    void flags(const State_T&, std::vector <std::size_t>&) const;
+
+    template <std::size_t Words>
+    void flags(const std::array <uint64_t, Words>&, std::vector <std::size_t>&) const;
+};
+
+
+
+template <typename String_T>
+RegexSet <String_T>::RegexSet(const std::vector <String_T> &patterns, const Options &options)
+    :
+    m_patterns(patterns.size())
+{
+    // dont build any caches for the throwaway single pattern regexes
+    Options single = options;
+    single.dfa_cache_limit = 0;
+    single.reverse_search = false;
+    single.dfa_states = 0;
+
+    std::vector <Regex_T> compiled;
+    compiled.reserve(patterns.size());
+
+    for(const String_T &pattern : patterns)
+    {
+        compiled.emplace_back(pattern, single);
+
+        // the shared NFA has a follow set per position anyway
+        compiled.back().materialize_chains();
+    }
+
+    compute_NFA(compiled);
+    compute_masks(compiled);
+
+    select_engine();
+};
+
+
+// pattern k's position p (1 <= p <= its size) goes to base_k + p - 1,
+// its accepting flag (bit 0) to bit k
+template <typename String_T>
+void RegexSet <String_T>::compute_NFA(const std::vector <Regex_T> &compiled)
+{
+    m_bits = m_patterns;
+    for(const Regex_T &regex : compiled)
+    {
+        m_bits += regex.m_size;
+    }
+
+    // bit 0 is both the start set slot and pattern 0's flag, keep one around
+    m_NFA.assign(std::max(m_bits, std::size_t(1)), State_T(m_bits + 1));
+
+    std::size_t base = m_patterns;
+    for(std::size_t pattern = 0; pattern < m_patterns; ++pattern)
+    {
+        const Regex_T &regex = compiled[pattern];
+
+        shift(regex.m_NFA[0], m_NFA[0], pattern, base);
+
+        for(std::size_t itr = 1; itr <= regex.m_size; ++itr)
+        {
+            shift(regex.m_NFA[itr], m_NFA[base + itr - 1], pattern, base);
+        }
+
+        base += regex.m_size;
+    }
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::compute_masks(const std::vector <Regex_T> &compiled)
+{
+    std::size_t units = std::size_t(1) << CHAR_BIT;
+
+    if constexpr (!BYTE_UNITS)
+    {
+        m_alphabet.clear();
+        for(const Regex_T &regex : compiled)
+        {
+            m_alphabet.insert(m_alphabet.end(), regex.m_alphabet.begin(), regex.m_alphabet.end());
+        }
+
+        std::sort(m_alphabet.begin(), m_alphabet.end());
+        m_alphabet.erase(std::unique(m_alphabet.begin(), m_alphabet.end()), m_alphabet.end());
+
+        units = m_alphabet.size() + 1;
+    }
+
+    // the symbol of a unit in regex; a run of the set lies within one run of
+    // every pattern
+    const auto member_symbol = [this](const Regex_T &regex, const std::size_t unit) -> uint32_t
+    {
+        if constexpr (BYTE_UNITS)
+        {
+            return regex.m_symbol_map[unit];
+        }
+        else
+        {
+            return regex.symbol(static_cast <Char_T>(unit ? m_alphabet[unit - 1] : 0));
+        }
+    };
+
+    // split the units pattern by pattern: two stay one symbol as long as every
+    // pattern so far gave them the same one, numbered in order of appearance
+    m_symbol_map.assign(units, 0);
+    std::size_t symbols = 1;
+
+    for(const Regex_T &regex : compiled)
+    {
+        std::unordered_map <uint64_t, uint32_t> split;
+
+        for(std::size_t unit = 0; unit < units; ++unit)
+        {
+            const uint64_t key = uint64_t(m_symbol_map[unit]) << 32 | member_symbol(regex, unit);
+
+            m_symbol_map[unit] = split.emplace(key, static_cast <uint32_t>(split.size())).first->second;
+        }
+
+        symbols = split.size();
+    }
+
+    // every symbol takes its masks from the first unit it stands for
+    std::vector <std::size_t> first(symbols, units);
+    for(std::size_t unit = units; unit-- > 0;)
+    {
+        first[m_symbol_map[unit]] = unit;
+    }
+
+    m_char_masks.assign(symbols, State_T(m_bits + 1));
+
+    std::size_t base = m_patterns;
+    for(const Regex_T &regex : compiled)
+    {
+        for(std::size_t symbol = 0; symbol < symbols; ++symbol)
+        {
+            shift(regex.m_char_masks[member_symbol(regex, first[symbol])], m_char_masks[symbol], 0, base);
+        }
+
+        base += regex.m_size;
+    }
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::select_engine()
+{
+    m_fixed = std::monostate();
+
+    if(m_bits + 1 <= Fixed_NFA <1>::CAPACITY)
+    {
+        m_fixed.template emplace <1>(m_NFA, m_char_masks);
+    }
+    else if(m_bits + 1 <= Fixed_NFA <2>::CAPACITY)
+    {
+        m_fixed.template emplace <2>(m_NFA, m_char_masks);
+    }
+    else if(m_bits + 1 <= Fixed_NFA <4>::CAPACITY)
+    {
+        m_fixed.template emplace <3>(m_NFA, m_char_masks);
+    }
+};
+
+
+// to |= from with bit 0 moved to flag and bit p >= 1 to base + p - 1
+template <typename String_T>
+void RegexSet <String_T>::shift(const State_T &from, State_T &to, const std::size_t flag, const std::size_t base)
+{
+    if(from.size() && from.test(0))
+    {
+        to.set(flag);
+    }
+
+    for(const std::size_t itr : from.ones(1))
+    {
+        to.set(base + itr - 1);
+    }
+};
+
+
+template <typename String_T>
+std::size_t RegexSet <String_T>::symbol(const Char_T chr) const noexcept
+{
+    if constexpr (BYTE_UNITS)
+    {
+        return m_symbol_map[Regex_T::code_unit(chr)];
+    }
+    else
+    {
+        return m_symbol_map[std::upper_bound(m_alphabet.begin(), m_alphabet.end(), Regex_T::code_unit(chr)) - m_alphabet.begin()];
+    }
+};
+
+
+template <typename String_T>
+std::size_t RegexSet <String_T>::size() const noexcept
+{
+    return m_patterns;
+};
+
+
+template <typename String_T>
+std::vector <std::size_t> RegexSet <String_T>::match(const View_T word) const
+{
+    Context context(*this);
+    std::vector <std::size_t> ids;
+
+    match(word, ids, context);
+
+    return ids;
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::match(const View_T word, std::vector <std::size_t> &ids, Context &context) const
+{
+    if(context.m_owner != m_identity.value())
+    {
+        context = Context(*this);
+    }
+
+    ids.clear();
+
+    with_engine([&](const auto &fixed)
+    {
+        if constexpr (std::is_same <std::decay_t <decltype(fixed)>, std::monostate>::value)
+        {
+            run_match(Bitset_Engine(*this, context), word, ids, context);
+        }
+        else
+        {
+            run_match(fixed, word, ids, context);
+        }
+    });
+};
+
+
+template <typename String_T>
+std::vector <std::size_t> RegexSet <String_T>::search(const View_T sample) const
+{
+    Context context(*this);
+    std::vector <std::size_t> ids;
+
+    search(sample, ids, context);
+
+    return ids;
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::search(const View_T sample, std::vector <std::size_t> &ids, Context &context) const
+{
+    if(context.m_owner != m_identity.value())
+    {
+        context = Context(*this);
+    }
+
+    ids.clear();
+
+    with_engine([&](const auto &fixed)
+    {
+        if constexpr (std::is_same <std::decay_t <decltype(fixed)>, std::monostate>::value)
+        {
+            run_search(Bitset_Engine(*this, context), sample, ids, context);
+        }
+        else
+        {
+            run_search(fixed, sample, ids, context);
+        }
+    });
+};
+
+
+// the usual walk, all patterns at once; the flags left in the final state
+// are the patterns that accept
+template <typename String_T>
+template <typename Engine_T>
+void RegexSet <String_T>::run_match(
+    const Engine_T &engine, const View_T word, std::vector <std::size_t> &ids, Context &context
+) const
+{
+    using Set_T = typename Engine_T::Set_T;
+
+    with_buffers(engine, context, [&](Set_T &state, Set_T &transition, Set_T&)
+    {
+        engine.start(state);
+
+        for(const Char_T chr : word)
+        {
+            // no pattern can match anymore
+            if(engine.dead(state))
+            {
+                return;
+            }
+
+            engine.step(state, symbol(chr), transition);
+            std::swap(state, transition);
+        }
+
+        flags(state, ids);
+    });
+};
+
+
+// .*R for all patterns: the start states are added at every offset and the
+// flags reached after any character are collected, all of them are needed
+// so there is no stopping early
+template <typename String_T>
+template <typename Engine_T>
+void RegexSet <String_T>::run_search(
+    const Engine_T &engine, const View_T sample, std::vector <std::size_t> &ids, Context &context
+) const
+{
+    using Set_T = typename Engine_T::Set_T;
+
+    with_buffers(engine, context, [&](Set_T &state, Set_T &transition, Set_T &seen)
+    {
+        engine.clear(state);
+        engine.clear(seen);
+
+        for(const Char_T chr : sample)
+        {
+            // the flags of nullable patterns come along, but no step keeps
+            // them, so empty matches are never seen
+            engine.restart(state);
+
+            engine.step(state, symbol(chr), transition);
+            std::swap(state, transition);
+
+            if constexpr (std::is_same <Set_T, State_T>::value)
+            {
+                seen |= state;
+            }
+            else
+            {
+                for(std::size_t word = 0; word < seen.size(); ++word)
+                {
+                    seen[word] |= state[word];
+                }
+            }
+        }
+
+        flags(seen, ids);
+    });
+};
+
+
+template <typename String_T>
+template <typename Function_T>
+decltype(auto) RegexSet <String_T>::with_engine(Function_T &&function) const
+{
+    switch(m_fixed.index())
+    {
+        case 1:
+            return function(std::get <1>(m_fixed));
+        case 2:
+            return function(std::get <2>(m_fixed));
+        case 3:
+            return function(std::get <3>(m_fixed));
+        default:
+            return function(std::monostate());
+    }
+};
+
+
+template <typename String_T>
+template <typename Engine_T, typename Function_T>
+decltype(auto) RegexSet <String_T>::with_buffers(const Engine_T &engine, Context &context, Function_T &&function)
+{
+    if constexpr (std::is_same <typename Engine_T::Set_T, State_T>::value)
+    {
+        return function(context.m_current, context.m_next, context.m_seen);
+    }
+    else
+    {
+        typename Engine_T::Set_T current = engine.empty();
+        typename Engine_T::Set_T next = engine.empty();
+        typename Engine_T::Set_T seen = engine.empty();
+
+        return function(current, next, seen);
+    }
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::flags(const State_T &state, std::vector <std::size_t> &ids) const
+{
+    for(std::size_t itr = state.find_first(); itr != State_T::npos && itr < m_patterns; itr = state.find_next(itr))
+    {
+        ids.push_back(itr);
+    }
+};
+
+
+template <typename String_T>
+template <std::size_t Words>
+void RegexSet <String_T>::flags(const std::array <uint64_t, Words> &state, std::vector <std::size_t> &ids) const
+{
+    for(std::size_t itr = 0; itr < m_patterns; ++itr)
+    {
+        if(state[itr / 64] & (uint64_t(1) << (itr % 64)))
+        {
+            ids.push_back(itr);
+        }
+    }
+};
+
+
+
+
+/*
+================================================================================
+------------------------------ rgx::RegexSet::Context --------------------------
+================================================================================
+*/
+
+template <typename String_T>
+RegexSet <String_T>::Context::Context()
+    :
+    m_owner(Identity::NONE)
+{};
+
+
+template <typename String_T>
+RegexSet <String_T>::Context::Context(const RegexSet &set)
+    :
+    m_owner(set.m_identity.value()),
+    m_current(set.m_bits + 1),
+    m_next(set.m_bits + 1),
+    m_active(set.m_bits + 1),
+    m_seen(set.m_bits + 1)
+{};
+
+
+
+
+/*
+================================================================================
+------------------------------ rgx::RegexSet::Bitset_Engine --------------------
+================================================================================
+*/
+
+template <typename String_T>
+RegexSet <String_T>::Bitset_Engine::Bitset_Engine(const RegexSet &set, Context &context)
+    :
+    m_set(set),
+    m_context(context)
+{};
+
+
+template <typename String_T>
+void RegexSet <String_T>::Bitset_Engine::start(State_T &state) const
+{
+    state = m_set.m_NFA[0];
+};
+
+
+template <typename String_T>
+typename RegexSet <String_T>::State_T
+RegexSet <String_T>::Bitset_Engine::empty() const
+{
+    return State_T(m_set.m_bits + 1);
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::Bitset_Engine::clear(State_T &state) const
+{
+    state.reset();
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::Bitset_Engine::restart(State_T &state) const
+{
+    state |= m_set.m_NFA[0];
+};
+
+
+template <typename String_T>
+void RegexSet <String_T>::Bitset_Engine::step(const State_T &from, const std::size_t symbol, State_T &to) const
+{
+    State_T &active = m_context.m_active;
+
+    active.assign_and(from, m_set.m_char_masks[symbol]);
+
+    to.reset();
+
+    // the masks hold no flags, so neither does active
+    for(const std::size_t itr : active.ones())
+    {
+        to |= m_set.m_NFA[itr];
+    }
+};
+
+
+
+template <typename String_T>
+bool RegexSet <String_T>::Bitset_Engine::dead(const State_T &state)
+{
+    return state.none();
+};
+
+
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace rgx
+{
+
+
+
+// compile-time trace hooks of Regex, its second template argument.
+// a sink is any type with these static members; No_Trace makes every one
+// an empty inline call, so an untraced Regex does no output at all.
+// Ostream_Trace, printing to std::cout, is in ostream_trace.hpp
+struct No_Trace
+{
+    // the pattern was compiled to postfix, positions labelled by labels
+    template <typename Exp_T, typename Labels_T>
+    static void compiled(const Exp_T&, const Labels_T&) noexcept {};
+
+    // match(word) returned result, word and the samples below are string views
+    // or Sample_Ranges
+    template <typename String_T>
+    static void matched(const String_T&, const bool) noexcept {};
+
+    // search found [begin, end) in sample
+    template <typename String_T>
+    static void found(const String_T&, const std::size_t, const std::size_t) noexcept {};
+
+    // search is done with sample, count matches were reported
+    template <typename String_T>
+    static void searched(const String_T&, const std::size_t) noexcept {};
+};
+
+
+
+}
@@ -0,0 +1,148 @@
+#include "regex.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+
+#include <sys/mman.h>
+
+
+
+// checks that borrowed tables are never written: bitsets borrowed from read
+// only pages are changed through every modifier, and patterns are viewed from
+// blobs on read only pages and searched; exits with 1 on a wrong result, a
+// write into the pages kills it
+//   g++ -std=c++17 -O2 view_check.cpp -o view_check && ./view_check
+
+
+
+// size bytes holding data, mapped read only
+static const void* read_only(const void *data, const std::size_t size)
+{
+    void *pages = mmap(nullptr, size ? size : 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(pages == MAP_FAILED)
+    {
+        std::cerr << "mmap failed" << std::endl;
+        std::exit(2);
+    }
+
+    std::memcpy(pages, data, size);
+    mprotect(pages, size ? size : 1, PROT_READ);
+
+    return pages;
+};
+
+
+
+int main()
+{
+    using Bitset_T = bit::Bitset <unsigned long>;
+
+    bool failed = false;
+    const auto check = [&](const bool ok, const char *what)
+    {
+        if(!ok)
+        {
+            std::cout << "wrong: " << what << std::endl;
+            failed = true;
+        }
+    };
+
+    // the last chunk partly used, copied out in place at 200 bits and to the heap at 1000
+    for(const std::size_t size : {200, 1000})
+    {
+        Bitset_T owned(size);
+        for(std::size_t itr = 0; itr < owned.size(); itr += 3)
+        {
+            owned.set(itr);
+        }
+
+        const Bitset_T &source = owned;
+        const std::size_t words = (size + CHAR_BIT * sizeof(unsigned long) - 1) / (CHAR_BIT * sizeof(unsigned long));
+        const auto *chunks = static_cast <const unsigned long*>(read_only(source.data(), words * sizeof(unsigned long)));
+
+        // every modifier on a fresh borrow, against the same on an owned copy
+        const auto modified = [&](const char *what, const auto &modify)
+        {
+            Bitset_T borrowed = Bitset_T::borrow(chunks, owned.size());
+            Bitset_T copy = owned;
+
+            modify(borrowed);
+            modify(copy);
+
+            check(borrowed == copy, what);
+        };
+
+        {
+            const Bitset_T borrowed = Bitset_T::borrow(chunks, owned.size());
+            check(borrowed == owned && borrowed.data() == chunks, "borrow");
+
+            Bitset_T copy = borrowed;
+            check(copy == owned && copy.data() != chunks, "copy");
+        }
+
+        modified("resize up", [](Bitset_T &bitset) { bitset.resize(300, true); });
+        modified("resize down", [](Bitset_T &bitset) { bitset.resize(70); });
+        modified("set", [](Bitset_T &bitset) { bitset.set(1); bitset.set(199); });
+        modified("set all", [](Bitset_T &bitset) { bitset.set(); });
+        modified("reset", [](Bitset_T &bitset) { bitset.reset(0); bitset.reset(); });
+        modified("flip", [](Bitset_T &bitset) { bitset.flip(5); bitset.flip(); });
+        modified("at", [](Bitset_T &bitset) { bitset.at(4) = true; });
+        modified("&=", [](Bitset_T &bitset) { bitset &= Bitset_T(200, true).reset(9); });
+        modified("|=", [](Bitset_T &bitset) { bitset |= Bitset_T(200).set(10); });
+        modified("^=", [](Bitset_T &bitset) { bitset ^= Bitset_T(200, true); });
+        modified("<<=", [](Bitset_T &bitset) { bitset <<= 67; });
+        modified(">>=", [](Bitset_T &bitset) { bitset >>= 67; });
+        modified("set_unchecked", [](Bitset_T &bitset) { bitset.set_unchecked(2).reset_unchecked(3); });
+        modified("assign_and", [](Bitset_T &bitset) { bitset.assign_and(bitset, Bitset_T(200, true).reset(9)); });
+        modified("assign_or", [](Bitset_T &bitset) { bitset.assign_or(Bitset_T(250).set(240), bitset); });
+        modified("assign_xor", [](Bitset_T &bitset) { bitset.assign_xor(bitset, bitset); });
+        modified("assign", [](Bitset_T &bitset) { bitset = Bitset_T(130, true); });
+        modified("clear", [](Bitset_T &bitset) { bitset.clear(); bitset.resize(64, true); });
+    }
+
+    // viewing a blob in read only memory finds what the compiled pattern finds
+    std::string large;
+    for(std::size_t itr = 0; itr < 40; ++itr)
+    {
+        large += (itr ? "|(ab*c|ba)x" : "(ab*c|ba)x") + std::string(1, char('a' + itr % 20));
+    }
+
+    std::string text;
+    for(std::size_t itr = 0; itr < 20000; ++itr)
+    {
+        text += "abbcxaabbxbabacxcabba"[itr % 21];
+    }
+
+    std::vector <rgx::Options> settings(3);
+    settings[1].reverse_search = true;
+    settings[2].dfa_states = 4096;
+
+    for(const std::string &pattern : {std::string("(a|b)*abb(c|a)*"), std::string("[a-c]{2,40}x"), large})
+    {
+        for(const rgx::Options &options : settings)
+        {
+            const rgx::Regex<> regex(pattern, options);
+            const std::string blob = regex.save(rgx::Blob::MAPPED);
+
+            const char *mapped = static_cast <const char*>(read_only(blob.data(), blob.size()));
+            const rgx::Regex<> viewed = rgx::Regex<>::view(std::string_view(mapped, blob.size()));
+
+            const std::vector <rgx::Match> found = viewed.search_results(text);
+            const std::vector <rgx::Match> expected = regex.search_results(text);
+            check(std::equal(found.begin(), found.end(), expected.begin(), expected.end(), [](const rgx::Match &lhs, const rgx::Match &rhs)
+            {
+                return lhs.begin == rhs.begin && lhs.end == rhs.end;
+            }), "view search");
+            check(viewed.match(text) == regex.match(text) && viewed.match("abbabb") == regex.match("abbabb"), "view match");
+        }
+    }
+
+    std::cout << (failed ? "failed" : "ok") << std::endl;
+
+    return failed ? 1 : 0;
+};